@@ -44,7 +44,8 @@ bool Bomb::use(Mouse* m) {
 	GetEntity()->SetParent(OmegaEngine::Instance().GetRoot());
 	GetEntity()->transform.setLocalPosition(pos);	// remember physics will override this 
 	_physics->zPos = (up) ? Z_UPPER : Z_LOWER;		// TODO: not 100% sure if PhysicsManager will automatically resolve masking
-	_physics->moveBody(new Vector2D(pos.x, pos.z), 0);
+	Vector2D bodyPos(pos.x, pos.z);
+	_physics->moveBody(&bodyPos, 0);
 
 	// make contraption "active"
 	_physics->SetEnabled(true);
@@ -62,7 +63,10 @@ bool Bomb::use(Mouse* m) {
 		PhysObjectType::CAT_UP
 	};
 	_dcollision->SetLayers(_checkFor);
-	_physics->moveBody(new Vector2D(pos.x, pos.z), 0);
+	_checkMask = 0;
+	for (auto t : _checkFor)
+		_checkMask |= PhysObjectType::mask(t);
+	_physics->moveBody(&bodyPos, 0);
 	auto vel = glm::vec2(dir.x, dir.z) * SPEED;
 	_physics->velocity = Vector2D(vel);
 	_physics->zVelocity = Bomb::VER_VEL;
@@ -79,11 +83,12 @@ void Bomb::Explode()
 	auto pos = GetEntity()->t().wPos();
 	auto bl = pos + glm::vec3(-1, 0, -1) * RADIUS;
 	auto tr = pos + glm::vec3(1, 0, 1) * RADIUS;
-	auto hits = PhysicsManager::instance()->areaCheck(nullptr, _checkFor, new Vector2D(bl.x, bl.z), new Vector2D(tr.x, tr.z));
+	PhysicsComponent* hits[MAX_QUERY_RESULTS];
+	size_t hitCount = PhysicsManager::instance()->areaQuery(_checkMask, Vector2D(bl.x, bl.z), Vector2D(tr.x, tr.z), hits, MAX_QUERY_RESULTS);
 
-	for (auto p : hits)
+	for (size_t i = 0; i < hitCount; i++)
 	{
-		auto health = p->GetEntity()->GetComponent<HealthComponent>();
+		auto health = hits[i]->GetEntity()->GetComponent<HealthComponent>();
 		if (health) health->Damage(DAMAGE);
 	}
 
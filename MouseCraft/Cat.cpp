@@ -12,13 +12,13 @@ Cat::Cat() :
 	HandleOnCollide(this, &Cat::OnCollision),
 	HandleOnHit(this, &Cat::OnHit)
 {
-    EventManager::Subscribe(INPUT_BUTTON, this);
     playerID = 0;
     current_time = 0;
 }
 
 Cat::~Cat()
 {
+    EventManager::Unsubscribe(INPUT_BUTTON, playerID, this);
 }
 
 void Cat::Update(float dt) {
@@ -26,9 +26,6 @@ void Cat::Update(float dt) {
         UpdateAttack(dt);
     }
 
-	PhysicsComponent* pComp = GetEntity()->GetComponent<PhysicsComponent>();
-	pComp->updateFalling();
-
 	if (isPouncing) {
         updatePounce(dt);
     }
@@ -43,9 +40,11 @@ void Cat::OnInitialized()
 	{
 		HandleOnCollide.Observe(pComp->onCollide);
 		HandleOnHit.Observe(pComp->onHit);
+		pComp->checksFalling = true;
 	}
 
     playerID = GetEntity()->GetComponent<PlayerComponent>()->GetID();
+    EventManager::Subscribe(INPUT_BUTTON, playerID, this);
 }
 
 //check for button presses and then call functions
@@ -53,7 +52,7 @@ void Cat::Notify(EventName eventName, Param * param) {
     UpdatableComponent::Notify(eventName, param);
     if (eventName == INPUT_BUTTON) {
         auto data = static_cast<TypeParam<ButtonEvent>*>(param)->Param;
-        if (data.player != playerID || data.isDown != true) {
+        if (data.isDown != true) {
             return;
         }
 
@@ -112,20 +111,14 @@ void Cat::Attack()
 
 void Cat::CheckHitbox(PhysicsComponent* pComp) {
     //check which level we're on
-    std::set<PhysObjectType::PhysObjectType> targets;
+    PhysObjectType::PhysObjectMask targets;
     if (pComp->isUp) {
         //generate check type
-        targets = std::set<PhysObjectType::PhysObjectType>{
-            PhysObjectType::OBSTACLE_UP,
-            PhysObjectType::MOUSE_UP
-        };
+        targets = PhysObjectType::mask(PhysObjectType::OBSTACLE_UP) | PhysObjectType::mask(PhysObjectType::MOUSE_UP);
     }
     else {
         //generate check type
-        targets = std::set<PhysObjectType::PhysObjectType>{
-            PhysObjectType::OBSTACLE_DOWN,
-            PhysObjectType::MOUSE_DOWN
-        };
+        targets = PhysObjectType::mask(PhysObjectType::OBSTACLE_DOWN) | PhysObjectType::mask(PhysObjectType::MOUSE_DOWN);
     }
 
     //determine our position for area check
@@ -138,7 +131,8 @@ void Cat::CheckHitbox(PhysicsComponent* pComp) {
     auto tr = pos + glm::vec3(2.2, 0, 2.2);
 
     //launch area check
-    auto results = pComp->areaCheck(targets, new Vector2D(bl.x, bl.z), new Vector2D(tr.x, tr.z));
+    PhysicsComponent* results[MAX_QUERY_RESULTS];
+    size_t resultCount = pComp->areaQuery(targets, Vector2D(bl.x, bl.z), Vector2D(tr.x, tr.z), results, MAX_QUERY_RESULTS);
 
 
 
@@ -159,11 +153,12 @@ void Cat::CheckHitbox(PhysicsComponent* pComp) {
     std::cout << facing.x << "," << facing.y << std::endl;
 
     //check if we hit something
-    if (results.size() > 0) {
+    if (resultCount > 0) {
         //Play a sound on hit here?
 
-		for (auto& p : results)
+		for (size_t i = 0; i < resultCount; i++)
 		{
+			PhysicsComponent* p = results[i];
 			if (p->pType == PhysObjectType::MOUSE_UP || p->pType == PhysObjectType::MOUSE_DOWN)
 			{
 				std::cout << "INFO: Cat hit a mouse!" << std::endl;
@@ -219,18 +214,14 @@ void Cat::Jump()
 			return;
 
 		//position of cat
-		Vector2D* curPos = new Vector2D(GetEntity()->transform.getLocalPosition().x, GetEntity()->transform.getLocalPosition().z);
+		Vector2D curPos(GetEntity()->transform.getLocalPosition().x, GetEntity()->transform.getLocalPosition().z);
 		//vector in front of cat of length = JUMP_DIST
-		Vector2D* jumpVec = new Vector2D(GetEntity()->transform.getLocalForward().x * CAT_JUMP_DIST, GetEntity()->transform.getLocalForward().z * CAT_JUMP_DIST);
-		jumpVec = new Vector2D(*curPos + *jumpVec);
-
-		std::set<PhysObjectType::PhysObjectType> types = std::set<PhysObjectType::PhysObjectType>{
-			PhysObjectType::PLATFORM
-		};
+		Vector2D jumpVec(GetEntity()->transform.getLocalForward().x * CAT_JUMP_DIST, GetEntity()->transform.getLocalForward().z * CAT_JUMP_DIST);
+		jumpVec = curPos + jumpVec;
 
-		Vector2D* hitPos = new Vector2D(0, 0);
+		Vector2D hitPos(0, 0);
 
-		PhysicsComponent* jumpTarget =  pComp->rayCheck(types, curPos, jumpVec, *hitPos);
+		PhysicsComponent* jumpTarget =  pComp->rayQuery(PhysObjectType::mask(PhysObjectType::PLATFORM), curPos, jumpVec, hitPos);
 
 		//check if we are in a location we can jump in
 		if (jumpTarget != nullptr) {
@@ -34,7 +34,7 @@ bool Coil::use(Mouse* m) {
 
 	// determine which layer to check for 
 	auto mousePhys = GetEntity()->GetParent()->GetComponent<PhysicsComponent>();
-	checkFor.insert(mousePhys->isUp ? PhysObjectType::CAT_UP : PhysObjectType::CAT_DOWN);
+	checkFor = PhysObjectType::mask(mousePhys->isUp ? PhysObjectType::CAT_UP : PhysObjectType::CAT_DOWN);
 
 	GetEntity()->AddComponent(c_physics);
 
@@ -64,8 +64,8 @@ void Coil::Update(float dt)
 	auto bl = glm::vec2(pos.x, pos.z) + glm::vec2(-1, -1) * (FIELD_RANGE / 2);
 	auto tr = glm::vec2(pos.x, pos.z) + glm::vec2(1, 1) * (FIELD_RANGE / 2);
 
-	auto hits = PhysicsManager::instance()->areaCheck(nullptr, checkFor, new Vector2D(bl), new Vector2D(tr));
-	bool hitCat = hits.size() > 0;
+	PhysicsComponent* hits[1];
+	bool hitCat = PhysicsManager::instance()->areaQuery(checkFor, Vector2D(bl), Vector2D(tr), hits, 1) > 0;
 
 	if (!_collidedCat && hitCat)
 	{
@@ -55,7 +55,7 @@ private:
 	PlayerComponent* _collidedCat;
 
 	// the floor which to check the cat for
-	std::set<PhysObjectType::PhysObjectType> checkFor;
+	PhysObjectType::PhysObjectMask checkFor = 0;
 	
 	Handler<Coil, PhysicsComponent*> HandleOnCollision;
 
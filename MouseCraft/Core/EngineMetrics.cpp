@@ -0,0 +1,39 @@
+#include "EngineMetrics.h"
+
+void EngineMetrics::Set(const std::string& name, double value)
+{
+	std::lock_guard<std::mutex> lock(_mtx);
+	_values[name] = value;
+}
+
+double EngineMetrics::Get(const std::string& name) const
+{
+	std::lock_guard<std::mutex> lock(_mtx);
+	auto it = _values.find(name);
+	return it != _values.end() ? it->second : 0.0;
+}
+
+std::map<std::string, double> EngineMetrics::Snapshot() const
+{
+	std::lock_guard<std::mutex> lock(_mtx);
+	return _values;
+}
+
+void EngineMetrics::LogOutput(const std::string filename)
+{
+	std::lock_guard<std::mutex> lock(_mtx);
+	_file.open("logs/" + filename, std::ofstream::out | std::ofstream::trunc);
+	_logging = true;
+}
+
+void EngineMetrics::FrameFinish(int frame)
+{
+	std::lock_guard<std::mutex> lock(_mtx);
+	if (!_logging) return;
+	_file << frame << ":";
+	for (const auto& value : _values)
+	{
+		_file << "   " << value.first << "=" << value.second;
+	}
+	_file << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <fstream>
+
+// Named performance numbers published by the engine's systems, so regressions
+// can be read from one place instead of each system's own profiler log.
+// Systems on any thread publish their latest values, the engine logs them once per frame.
+class EngineMetrics
+{
+public:
+	static EngineMetrics& Instance()
+	{
+		static EngineMetrics _instance;
+		return _instance;
+	}
+	EngineMetrics(EngineMetrics const&) = delete;
+	void operator=(EngineMetrics const&) = delete;
+private:
+	EngineMetrics() {};
+
+// variables 
+private:
+	mutable std::mutex _mtx;
+	std::map<std::string, double> _values;
+	std::ofstream _file;
+	bool _logging = false;
+
+// functions 
+public:
+	// Replace the latest value of a metric. Thread safe.
+	void Set(const std::string& name, double value);
+
+	// Gets the latest value of a metric, 0 if it was never set. Thread safe.
+	double Get(const std::string& name) const;
+
+	// Gets a copy of every metric. Thread safe.
+	std::map<std::string, double> Snapshot() const;
+
+	// Write every metric to a file in logs/ each frame.
+	void LogOutput(const std::string filename);
+
+	// Call once per frame to log the latest values.
+	void FrameFinish(int frame);
+};
\ No newline at end of file
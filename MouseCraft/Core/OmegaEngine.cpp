@@ -3,6 +3,7 @@
 #include <SDL2/SDL.h>
 #include "../gl/glad.h"
 #include "TaskScheduler.h"
+#include "EngineMetrics.h"
 #include "../Event/EventManager.h"
 #include "../Graphics/Window.h" 
 
@@ -17,6 +18,7 @@ void OmegaEngine::initialize()
 	// measure performance 
 	_profiler.InitializeTimers(7);
 	_profiler.LogOutput("Engine.log");	// optional
+	EngineMetrics::Instance().LogOutput("Metrics.log");	// optional
 	// _profiler.PrintOutput(true);		// optional
 	// _profiler.FormatMilliseconds(true);	// optional
 
@@ -186,10 +188,16 @@ void OmegaEngine::sequential_loop()
 		_profiler.StopTimer(5);
 
 		_profiler.StopTimer(0);
+
+		// Publish the loop's own timings next to what the systems reported
+		EngineMetrics& metrics = EngineMetrics::Instance();
+		metrics.Set("engine.frame_ms", _profiler.GetDurationSec(0) * 1000.0);
+		metrics.Set("engine.components_ms", _profiler.GetDurationSec(4) * 1000.0);
+		metrics.Set("engine.systems_ms", _profiler.GetDurationSec(5) * 1000.0);
+		metrics.FrameFinish(_frameCount);
 		_profiler.FrameFinish();
 
-		// PHASE 4: Buffer swap and Input Poll (SDL specific)
-		SDL_GL_SwapWindow(_window->getSDLWindow());
+		// PHASE 4: Frame end (the render thread swaps buffers once it has drawn the frame)
 		++_frameCount;
 	}
 }
@@ -5,6 +5,7 @@
 class Task
 {
 public:
+	virtual ~Task() {}
 	virtual void Execute();
 };
 
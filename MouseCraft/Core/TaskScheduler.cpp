@@ -35,6 +35,15 @@ TaskScheduler::TaskScheduler()
 
 TaskScheduler::~TaskScheduler()
 {
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		stopping = true;
+	}
+	cv.notify_all();
+	for (std::thread& t : threads)
+	{
+		t.join();
+	}
 }
 
 void TaskScheduler::ScheduleTask(Task * task)
@@ -88,7 +97,8 @@ void TaskScheduler::ProcessTask()
 		// retrieve task 
 		std::unique_lock<std::mutex> lock(mtx);
 		
-		while (tasks.empty()) cv.wait(lock);
+		while (tasks.empty() && !stopping) cv.wait(lock);
+		if (tasks.empty()) return;
 		auto t = tasks.front();
 		tasks.pop();
 
@@ -96,19 +106,92 @@ void TaskScheduler::ProcessTask()
 
 		// execute task 
 		// std::cout << std::this_thread::get_id() << std::endl;
-		t->Execute();
-		delete(t);
+		RunTask(t);
+	}
+}
+
+void TaskScheduler::RunTask(Task* task)
+{
+	task->Execute();
+	delete(task);
+	{
+		// Decrement under the wait lock so Wait can't miss the notify
+		std::unique_lock<std::mutex> waitLock(waitMtx);
 		--runningTask;
-		
-		waitCv.notify_one();
 	}
+	waitCv.notify_all();
 }
 
 void TaskScheduler::Wait()
 {
-	while (runningTask > 0)
+	std::unique_lock<std::mutex> lock(waitMtx);
+	waitCv.wait(lock, [this] { return runningTask <= 0; });
+}
+
+namespace
+{
+	// The chunks of one ParallelFor call still running on the pool
+	struct ChunkGroup
+	{
+		std::mutex mtx;
+		std::condition_variable cv;
+		size_t remaining;
+	};
+
+	class ChunkTask : public Task
 	{
-		std::unique_lock<std::mutex> lock(waitMtx);
-		waitCv.wait(lock);
+	public:
+		ChunkTask(std::function<void(size_t, size_t, size_t)>& func, ChunkGroup& group, size_t begin, size_t end, size_t chunk)
+			: func(func), group(group), begin(begin), end(end), chunk(chunk) {}
+		void Execute() override
+		{
+			func(begin, end, chunk);
+			// Notify under the lock, the group lives on the caller's stack and goes away once it sees 0
+			std::unique_lock<std::mutex> lock(group.mtx);
+			--group.remaining;
+			group.cv.notify_all();
+		}
+	private:
+		std::function<void(size_t, size_t, size_t)>& func;
+		ChunkGroup& group;
+		size_t begin, end, chunk;
+	};
+}
+
+size_t TaskScheduler::ChunkCount(size_t count, size_t minChunkSize)
+{
+	if (count == 0) return 0;
+	size_t size = std::max(minChunkSize, (size_t)1);
+	size_t chunks = (count + size - 1) / size;
+	return std::max(std::min(chunks, threads.size() + 1), (size_t)1);
+}
+
+void TaskScheduler::ParallelFor(size_t count, size_t minChunkSize, std::function<void(size_t, size_t, size_t)> func)
+{
+	size_t chunks = ChunkCount(count, minChunkSize);
+	if (chunks == 0) return;
+	// Spread the remainder so every chunk is in range and none is empty
+	ChunkGroup group;
+	group.remaining = chunks - 1;
+	for (size_t i = 1; i < chunks; i++)
+	{
+		ScheduleTask(new ChunkTask(func, group, i * count / chunks, (i + 1) * count / chunks, i));
+	}
+	func(0, count / chunks, 0);
+
+	// Help with queued tasks instead of blocking, since a call from inside a task
+	// could otherwise wait on chunks that no free thread is left to take
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(group.mtx);
+			if (group.remaining == 0) return;
+		}
+		Task* t = Retrieve();
+		if (t == nullptr) break;
+		RunTask(t);
 	}
+	// Every chunk left has been taken by a thread that is running it
+	std::unique_lock<std::mutex> lock(group.mtx);
+	group.cv.wait(lock, [&group] { return group.remaining == 0; });
 }
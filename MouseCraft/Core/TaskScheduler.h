@@ -5,6 +5,7 @@
 #include <queue>
 #include <thread>
 #include <atomic>
+#include <functional>
 #include "Task.h"
 
 class TaskScheduler
@@ -23,6 +24,7 @@ public:
 	std::atomic<int> runningTask;
 	std::mutex waitMtx;
 	std::condition_variable waitCv;
+	bool stopping = false;
 
 public: 
 
@@ -32,7 +34,18 @@ public:
 
 	void ProcessTask();
 
+	// Executes and deletes a retrieved task, then marks it finished for Wait.
+	void RunTask(Task* task);
+
 	void Wait();
 
+	// How many chunks ParallelFor will split count items into, for sizing per-chunk buffers.
+	size_t ChunkCount(size_t count, size_t minChunkSize);
+
+	// Splits [0, count) into ChunkCount chunks and runs func(begin, end, chunk) on each,
+	// one on the calling thread and the rest on the pool. Returns once every chunk is done.
+	// Only waits on its own chunks, so it can be called from inside a task.
+	void ParallelFor(size_t count, size_t minChunkSize, std::function<void(size_t, size_t, size_t)> func);
+
 };
 
@@ -209,7 +209,12 @@ void Transform::computeLocalTransformation()
 
 void Transform::computeWorldTransformation(glm::mat4 parent)
 {
-	_worldTransformation = parent * _localTransformation;
+	glm::mat4 world = parent * _localTransformation;
+	if (world != _worldTransformation)
+	{
+		_worldTransformation = world;
+		_worldVersion++;
+	}
 }
 
 float Transform::getAngle2D(glm::vec2 dir)
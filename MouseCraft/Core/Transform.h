@@ -78,6 +78,10 @@ public:
 	// Gets the world transformation matrix. 
 	glm::mat4 getWorldTransformation() const;
 
+	// Gets a counter that goes up whenever the world transformation changes. 
+	// Caches of the world transformation compare it to know when to refresh. 
+	unsigned int getWorldVersion() const { return _worldVersion; }
+
 	// Face towards the direction vector 
 	void face2D(glm::vec2 dir);
 	void face2D(glm::vec3 dir);
@@ -147,4 +151,5 @@ private:
 	glm::vec3 _localScale = glm::vec3(1.0f);
 	glm::mat4 _localTransformation;
 	glm::mat4 _worldTransformation;
+	unsigned int _worldVersion = 0;
 };
@@ -15,6 +15,10 @@ UpdatableComponent::~UpdatableComponent()
 
 void UpdatableComponent::Notify(EventName eventName, Param * params)
 {
+	// derived components forward their other subscriptions here, only tick on update
+	if (eventName != COMPONENT_UPDATE)
+		return;
+
 	if (GetEnabled() && GetEntity() && GetEntity()->GetActive())
 	{
 		auto delta = static_cast<TypeParam<float>*>(params);
@@ -1,5 +1,6 @@
 #include "EventManager.h"
 std::map<EventName, std::set<ISubscriber*>> EventManager::_eventMap;
+std::map<EventManager::EventKey, std::set<ISubscriber*>> EventManager::_keyedEventMap;
 
 void EventManager::Notify(EventName eventName, Param* params, bool async) {
     if (async) {
@@ -36,6 +37,43 @@ void EventManager::notifySubscribers(EventName eventName, Param* params) {
     if (event != _eventMap.end()) {
         std::set<ISubscriber*> subscriberList = event->second;
 
+        for (auto subscriber : subscriberList) {
+            subscriber->Notify(eventName, params);
+        }
+    }
+}
+
+void EventManager::Notify(EventName eventName, int key, Param* params, bool async) {
+    if (async) {
+        std::thread t(&notifyKeyedSubscribers, eventName, key, params);
+        t.detach();
+    } else {
+        notifyKeyedSubscribers(eventName, key, params);
+    }
+}
+
+void EventManager::Subscribe(EventName eventName, int key, ISubscriber* subscriber) {
+    _keyedEventMap[EventKey(eventName, key)].insert(subscriber);
+}
+
+void EventManager::Unsubscribe(EventName eventName, int key, ISubscriber* subscriber) {
+    auto event = _keyedEventMap.find(EventKey(eventName, key));
+    if (event != _keyedEventMap.end()) {
+        event->second.erase(subscriber);
+        if (event->second.empty()) {
+            _keyedEventMap.erase(event);
+        }
+    }
+}
+
+void EventManager::notifyKeyedSubscribers(EventName eventName, int key, Param* params) {
+    // listeners of the whole event still hear every channel
+    notifySubscribers(eventName, params);
+
+    auto event = _keyedEventMap.find(EventKey(eventName, key));
+    if (event != _keyedEventMap.end()) {
+        std::set<ISubscriber*> subscriberList = event->second;
+
         for (auto subscriber : subscriberList) {
             subscriber->Notify(eventName, params);
         }
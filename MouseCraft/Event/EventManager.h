@@ -22,9 +22,23 @@ public:
 
     // Unsubscribes the specified subscriber from an event
     static void Unsubscribe(EventName eventName, ISubscriber* subscriber);
+
+    // Use to notify subscribers of the specified event on a single channel (ie. a player ID).
+    // Subscribers of the channel and subscribers of the whole event are notified.
+    static void Notify(EventName eventName, int key, Param* params, bool async = false);
+
+    // Subscribes the specified subscriber to a single channel of an event
+    static void Subscribe(EventName eventName, int key, ISubscriber* subscriber);
+
+    // Unsubscribes the specified subscriber from a single channel of an event
+    static void Unsubscribe(EventName eventName, int key, ISubscriber* subscriber);
 private:
+    typedef std::pair<EventName, int> EventKey;
+
     static std::map<EventName, std::set<ISubscriber*>> _eventMap;
+    static std::map<EventKey, std::set<ISubscriber*>> _keyedEventMap;
     static void notifySubscribers(EventName eventName, Param* params);
+    static void notifyKeyedSubscribers(EventName eventName, int key, Param* params);
 
     EventManager() {}
 };
\ No newline at end of file
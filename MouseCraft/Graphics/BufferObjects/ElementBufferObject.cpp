@@ -2,7 +2,7 @@
 
 using std::vector;
 
-ElementBufferObject::ElementBufferObject() {
+ElementBufferObject::ElementBufferObject() : _capacity(0) {
 	glGenBuffers(1, &_id);
 }
 
@@ -10,14 +10,41 @@ ElementBufferObject::~ElementBufferObject() {
 	glDeleteBuffers(1, &_id);
 }
 
-void ElementBufferObject::buffer(vector<GLuint>& elements) {
+void ElementBufferObject::buffer(const vector<GLuint>& elements) {
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _id);
 	glBufferData(
 		GL_ELEMENT_ARRAY_BUFFER,
 		elements.size() * sizeof(GLuint),
-		static_cast<void*>(&elements[0]),
+		static_cast<const void*>(&elements[0]),
 		GL_STATIC_DRAW
 	);
+	_capacity = elements.size();
+}
+
+void ElementBufferObject::reserve(size_t count, size_t keep) {
+	// Copy targets are used so the element binding of the current VAO is left alone
+	GLuint old = _id;
+	glGenBuffers(1, &_id);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+	glBufferData(GL_COPY_WRITE_BUFFER, count * sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+	if (keep > 0) {
+		glBindBuffer(GL_COPY_READ_BUFFER, old);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, keep * sizeof(GLuint));
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	glDeleteBuffers(1, &old);
+	_capacity = count;
+}
+
+void ElementBufferObject::bufferSubData(size_t offset, const GLuint* elements, size_t count) {
+	glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, offset * sizeof(GLuint), count * sizeof(GLuint), elements);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+size_t ElementBufferObject::getCapacity() {
+	return _capacity;
 }
 
 GLuint ElementBufferObject::getID() {
@@ -32,7 +32,30 @@ public:
 	/// This automatically binds the EBO if it is not bound.
 	/// </summary>
 	/// <param name="elements">The array of vertex indices</param>
-	void buffer(std::vector<GLuint>& elements);
+	void buffer(const std::vector<GLuint>& elements);
+
+	/// <summary>
+	/// Reallocate the EBO to hold count indices, keeping the first keep indices.
+	/// This replaces the OpenGL buffer, so any VAO using it must be set again.
+	/// </summary>
+	/// <param name="count">The number of indices the EBO can hold</param>
+	/// <param name="keep">The number of existing indices to copy over</param>
+	void reserve(size_t count, size_t keep = 0);
+
+	/// <summary>
+	/// Overwrite part of the EBO without reallocating it.
+	/// This doesn't touch the bound VAO.
+	/// </summary>
+	/// <param name="offset">The first index to overwrite</param>
+	/// <param name="elements">The vertex indices to write</param>
+	/// <param name="count">The number of vertex indices to write</param>
+	void bufferSubData(size_t offset, const GLuint* elements, size_t count);
+
+	/// <summary>
+	/// Get the number of indices the EBO can hold
+	/// </summary>
+	/// <returns>The EBO capacity in indices</returns>
+	size_t getCapacity();
 	
 	/// <summary>
 	/// Bind the EBO in OpenGL using glBindBuffer
@@ -50,4 +73,9 @@ private:
 	/// The ID used by OpenGL to identify the EBO
 	/// </summary>
 	GLuint _id;
+
+	/// <summary>
+	/// The number of indices allocated on the GPU
+	/// </summary>
+	size_t _capacity;
 };
\ No newline at end of file
@@ -18,10 +18,38 @@ FrameBufferObject::FrameBufferObject(int width, int height, vector<GLTexture*>&
 	}
 }
 
+FrameBufferObject::FrameBufferObject(int width, int height, const vector<GLTexture*>& colors, GLTexture* depth) : _rbo(0), _width(width), _height(height) {
+	glGenFramebuffers(1, &_id);
+	RenderUtil::checkGLError("glGenFramebuffers");
+	vector<GLuint> attachments;
+	for (size_t i = 0; i < colors.size(); i++) {
+		GLuint attachment = GL_COLOR_ATTACHMENT0 + i;
+		attachments.push_back(attachment);
+		buffer(attachment, *colors[i]);
+	}
+	if (depth != nullptr) {
+		buffer(GL_DEPTH_STENCIL_ATTACHMENT, *depth);
+	}
+	bind();
+	if (attachments.empty()) {
+		glDrawBuffer(GL_NONE);
+	}
+	else {
+		glDrawBuffers(attachments.size(), &attachments[0]);
+	}
+	auto fboStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	if (fboStatus != GL_FRAMEBUFFER_COMPLETE) {
+		std::cout << "Framebuffer not complete: " << fboStatus << std::endl;
+	}
+	unbind();
+}
+
 FrameBufferObject::~FrameBufferObject() {
 	glDeleteFramebuffers(1, &_id);
 	RenderUtil::checkGLError("glDeleteFramebuffers");
-	glDeleteRenderbuffers(1, &_rbo);
+	if (_rbo != 0) {
+		glDeleteRenderbuffers(1, &_rbo);
+	}
 }
 
 void FrameBufferObject::attachBuffers(std::vector<GLTexture*>& buffers) {
@@ -18,6 +18,16 @@ public:
 	/// <param name="height">The height of the FBO</param>
 	/// <param name="textures">The color attachments to put in the FBO</param>
 	FrameBufferObject(int width, int height, std::vector<GLTexture*>& textures);
+
+	/// <summary>
+	/// Initializes the FBO around textures that already have storage.
+	/// No depth buffer is generated, the depth texture is attached instead if there is one.
+	/// </summary>
+	/// <param name="width">The width of every attachment</param>
+	/// <param name="height">The height of every attachment</param>
+	/// <param name="colors">The color attachments, in draw buffer order</param>
+	/// <param name="depth">A depth-stencil texture, or null for none</param>
+	FrameBufferObject(int width, int height, const std::vector<GLTexture*>& colors, GLTexture* depth);
 	
 	/// <summary>
 	/// Destructs the FBO, destroying it in OpenGL
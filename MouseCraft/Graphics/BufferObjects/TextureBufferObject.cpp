@@ -0,0 +1,42 @@
+#include "TextureBufferObject.h"
+#include "../RenderUtil.h"
+
+TextureBufferObject::TextureBufferObject(GLenum format) : _format(format) {
+	glGenBuffers(1, &_id);
+	glGenTextures(1, &_texture);
+	glBindBuffer(GL_TEXTURE_BUFFER, _id);
+	glBindTexture(GL_TEXTURE_BUFFER, _texture);
+	glTexBuffer(GL_TEXTURE_BUFFER, _format, _id);
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+TextureBufferObject::~TextureBufferObject() {
+	glDeleteTextures(1, &_texture);
+	glDeleteBuffers(1, &_id);
+}
+
+void TextureBufferObject::stream(const void* data, size_t bytes) {
+	glBindBuffer(GL_TEXTURE_BUFFER, _id);
+	// An empty buffer isn't a valid texture, so always keep something allocated
+	glBufferData(GL_TEXTURE_BUFFER, bytes > 0 ? bytes : 16, nullptr, GL_STREAM_DRAW);
+	if (bytes > 0) {
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, data);
+	}
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+	RenderUtil::checkGLError("TextureBufferObject::stream");
+}
+
+void TextureBufferObject::bind(GLenum slot) {
+	glActiveTexture(slot);
+	glBindTexture(GL_TEXTURE_BUFFER, _texture);
+}
+
+void TextureBufferObject::unbind(GLenum slot) {
+	glActiveTexture(slot);
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+GLuint TextureBufferObject::getID() {
+	return _id;
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+#include "../../GL/glad.h"
+
+// A buffer read in shaders through texelFetch on a samplerBuffer.
+// Unlike a uniform block its size isn't fixed in the shader, so it can hold per-frame lists.
+class TextureBufferObject {
+public:
+	TextureBufferObject(GLenum format);
+	~TextureBufferObject();
+	// Replaces the contents, orphaning the old storage like VertexBufferObject::stream
+	void stream(const void* data, size_t bytes);
+	void bind(GLenum slot);
+	void unbind(GLenum slot);
+	GLuint getID();
+private:
+	GLuint _id;
+	GLuint _texture;
+	GLenum _format;
+};
\ No newline at end of file
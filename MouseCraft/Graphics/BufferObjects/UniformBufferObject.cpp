@@ -1,6 +1,6 @@
 #include "UniformBufferObject.h"
 
-UniformBufferObject::UniformBufferObject() {
+UniformBufferObject::UniformBufferObject() : _allocated(0) {
 	glGenBuffers(1, &_id);
 }
 
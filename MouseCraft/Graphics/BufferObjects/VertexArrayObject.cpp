@@ -20,6 +20,19 @@ void VertexArrayObject::setBuffer(int id, VertexBufferObject& vbo, int offset) {
 	_vbos[id] = &vbo;
 }
 
+void VertexArrayObject::setAttribute(int id, VertexBufferObject& vbo, int components, int stride, size_t offset, int divisor) {
+	setAttribute(id, vbo, components, GL_FLOAT, false, stride, offset, divisor);
+}
+
+void VertexArrayObject::setAttribute(int id, VertexBufferObject& vbo, int components, GLenum type, bool normalized, int stride, size_t offset, int divisor) {
+	bind();
+	vbo.bind();
+	glEnableVertexAttribArray(id);
+	glVertexAttribPointer(id, components, type, normalized ? GL_TRUE : GL_FALSE, stride, (void *)offset);
+	glVertexAttribDivisor(id, divisor);
+	_vbos[id] = &vbo;
+}
+
 void VertexArrayObject::unsetBuffer(int buffID) {
 	bind();
 	glEnableVertexAttribArray(0);
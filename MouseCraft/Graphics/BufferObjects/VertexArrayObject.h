@@ -9,6 +9,11 @@ public:
 	~VertexArrayObject();
 	GLuint getID();
 	void setBuffer(int id, VertexBufferObject& vbo, int offset = 0);
+	// Points an attribute at interleaved float data in a VBO.
+	// A divisor of 1 advances the attribute once per instance instead of per vertex.
+	void setAttribute(int id, VertexBufferObject& vbo, int components, int stride, size_t offset, int divisor = 0);
+	// Points an attribute at interleaved data of any type, normalized integers read as [-1, 1] or [0, 1].
+	void setAttribute(int id, VertexBufferObject& vbo, int components, GLenum type, bool normalized, int stride, size_t offset, int divisor = 0);
 	void unsetBuffer(int id);
 	void setElementBuffer(ElementBufferObject& ebo);
 	void bind();
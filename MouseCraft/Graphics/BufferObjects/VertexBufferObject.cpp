@@ -2,7 +2,7 @@
 
 using std::vector;
 
-VertexBufferObject::VertexBufferObject(int componentsPerElement) : _componentsPerElement(componentsPerElement) {
+VertexBufferObject::VertexBufferObject(int componentsPerElement) : _componentsPerElement(componentsPerElement), _capacity(0) {
 	glGenBuffers(1, &_id);
 }
 
@@ -22,6 +22,44 @@ void VertexBufferObject::buffer(vector<GLfloat>& values) {
 		static_cast<void*>(&values[0]),
 		GL_STATIC_DRAW
 	);
+	_capacity = values.size();
+}
+
+void VertexBufferObject::reserve(size_t count, size_t keep) {
+	GLuint old = _id;
+	glGenBuffers(1, &_id);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+	glBufferData(GL_COPY_WRITE_BUFFER, count * sizeof(GLfloat), nullptr, GL_STATIC_DRAW);
+	if (keep > 0) {
+		glBindBuffer(GL_COPY_READ_BUFFER, old);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, keep * sizeof(GLfloat));
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	glDeleteBuffers(1, &old);
+	_capacity = count;
+}
+
+void VertexBufferObject::bufferSubData(size_t offset, const GLfloat* values, size_t count) {
+	glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, offset * sizeof(GLfloat), count * sizeof(GLfloat), values);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void VertexBufferObject::stream(const void* data, size_t bytes) {
+	glBindBuffer(GL_ARRAY_BUFFER, _id);
+	size_t count = (bytes + sizeof(GLfloat) - 1) / sizeof(GLfloat);
+	if (count > _capacity) {
+		_capacity = count;
+	}
+	glBufferData(GL_ARRAY_BUFFER, _capacity * sizeof(GLfloat), nullptr, GL_STREAM_DRAW);
+	if (bytes > 0) {
+		glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, data);
+	}
+}
+
+size_t VertexBufferObject::getCapacity() {
+	return _capacity;
 }
 
 int VertexBufferObject::getComponentsPerElement() {
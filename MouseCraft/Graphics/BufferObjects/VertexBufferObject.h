@@ -8,9 +8,19 @@ public:
 	GLuint getID();
 	int getComponentsPerElement();
 	void buffer(std::vector<GLfloat>& values);
+	// Reallocates the buffer to hold count floats, keeping the first keep floats.
+	// This replaces the OpenGL buffer, so any VAO using it must be set again.
+	void reserve(size_t count, size_t keep = 0);
+	// Overwrites part of the buffer, starting at offset floats. Doesn't reallocate.
+	void bufferSubData(size_t offset, const GLfloat* values, size_t count);
+	// Replaces the contents with per-frame data, orphaning the old storage so the
+	// driver doesn't have to wait on draws still reading it.
+	void stream(const void* data, size_t bytes);
+	size_t getCapacity();
 	void bind();
 	void unbind();
 private:
 	GLuint _id;
 	int _componentsPerElement;
+	size_t _capacity;
 };
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "DynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+
+DynamicResolution::DynamicResolution(const DynamicResolutionSettings& settings)
+	: _settings(settings), _average(0.0), _hasSample(false), _framesSinceChange(0), _framesUnderBudget(0) {
+	_settings.minScale = std::min(std::max(_settings.minScale, 0.1f), 1.0f);
+	_settings.maxScale = std::min(std::max(_settings.maxScale, _settings.minScale), 1.0f);
+	_settings.step = std::max(_settings.step, 0.01f);
+	_scale = _settings.maxScale;
+}
+
+float DynamicResolution::update(double frameMs) {
+	if (frameMs <= 0.0) return _scale;
+
+	if (_hasSample) {
+		_average += _settings.smoothing * (frameMs - _average);
+	}
+	else {
+		_average = frameMs;
+		_hasSample = true;
+	}
+
+	// The timings lag the resolution by a frame or two and the average lags further, let them catch up
+	_framesSinceChange++;
+	if (_framesSinceChange < _settings.settleFrames) return _scale;
+
+	double target = _settings.targetFrameMs;
+	float scale = _scale;
+	if (_average > target * _settings.downThreshold) {
+		// Cost goes with the pixel count, which goes with the square of the scale
+		scale = quantize(_scale * (float)std::sqrt(target / _average));
+		// Over budget always costs at least a step, even when rounding would keep the scale
+		scale = std::min(scale, _scale - _settings.step);
+		_framesUnderBudget = 0;
+	}
+	else if (_average < target * _settings.upThreshold) {
+		_framesUnderBudget++;
+		float next = quantize(_scale + _settings.step);
+		double predicted = _average * (next / _scale) * (next / _scale);
+		// Only grow if the larger size is expected to stay within budget, or we'd shrink again right away
+		if (_framesUnderBudget >= _settings.settleFrames && predicted < target) {
+			scale = next;
+		}
+	}
+	else {
+		_framesUnderBudget = 0;
+	}
+
+	scale = std::min(std::max(scale, _settings.minScale), _settings.maxScale);
+	if (scale != _scale) {
+		_scale = scale;
+		_framesSinceChange = 0;
+		_framesUnderBudget = 0;
+	}
+	return _scale;
+}
+
+float DynamicResolution::getScale() {
+	return _scale;
+}
+
+double DynamicResolution::getAverageFrameMs() {
+	return _average;
+}
+
+float DynamicResolution::quantize(float scale) {
+	// Round rather than floor, 0.95 / 0.05 can come out just under 19
+	return std::floor(scale / _settings.step + 0.5f) * _settings.step;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+/// <summary>
+/// Bounds and hysteresis for DynamicResolution. The defaults aim for 60 Hz with some headroom.
+/// Set minScale equal to maxScale to render at a fixed resolution.
+/// </summary>
+struct DynamicResolutionSettings {
+	// The time the frame's rendering should take, in milliseconds
+	float targetFrameMs = 14.0f;
+	// The smallest and largest render scale, as a fraction of the window's width and height
+	float minScale = 0.5f;
+	float maxScale = 1.0f;
+	// Scales are multiples of this, so small changes in timing don't reallocate the targets
+	float step = 0.05f;
+	// Shrink when the average is above targetFrameMs * downThreshold,
+	// grow when it has stayed below targetFrameMs * upThreshold
+	float downThreshold = 1.05f;
+	float upThreshold = 0.8f;
+	// Frames to wait after a change before the next one, and frames under budget before growing
+	int settleFrames = 30;
+	// Weight of the newest frame in the running average
+	float smoothing = 0.1f;
+};
+
+/// <summary>
+/// Picks the internal render resolution from recent frame times.
+/// Shrinks in proportion to how far over budget the frame is, and grows one step at a time
+/// only after a run of cheap frames, so the resolution doesn't flip between two sizes.
+/// </summary>
+class DynamicResolution {
+public:
+	DynamicResolution(const DynamicResolutionSettings& settings);
+
+	/// <summary>
+	/// Feed the time a frame took and get the scale to render the next one at
+	/// </summary>
+	/// <param name="frameMs">The frame's render time in milliseconds, ignored if not positive</param>
+	/// <returns>The render scale, between minScale and maxScale</returns>
+	float update(double frameMs);
+
+	/// <summary>
+	/// Get the current render scale
+	/// </summary>
+	float getScale();
+
+	/// <summary>
+	/// Get the running average of the frame time in milliseconds
+	/// </summary>
+	double getAverageFrameMs();
+private:
+	float quantize(float scale);
+
+	DynamicResolutionSettings _settings;
+	float _scale;
+	double _average;
+	bool _hasSample;
+	int _framesSinceChange;
+	int _framesUnderBudget;
+};
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "Frustum.h"
+#include <xmmintrin.h>
+
+Frustum::Frustum(const glm::mat4& viewProjection) {
+	// Gribb/Hartmann plane extraction, glm matrices are column major
+	glm::vec4 rows[4];
+	for (int i = 0; i < 4; i++) {
+		rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+	}
+	_planes[0] = rows[3] + rows[0]; // Left
+	_planes[1] = rows[3] - rows[0]; // Right
+	_planes[2] = rows[3] + rows[1]; // Bottom
+	_planes[3] = rows[3] - rows[1]; // Top
+	_planes[4] = rows[3] + rows[2]; // Near
+	_planes[5] = rows[3] - rows[2]; // Far
+	for (glm::vec4& plane : _planes) {
+		plane /= glm::length(glm::vec3(plane));
+	}
+}
+
+bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const {
+	for (const glm::vec4& plane : _planes) {
+		if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::intersectsBox(const glm::vec3& center, const glm::vec3& extents) const {
+	for (const glm::vec4& plane : _planes) {
+		glm::vec3 normal(plane);
+		float reach = glm::dot(extents, glm::abs(normal));
+		if (glm::dot(normal, center) + plane.w < -reach) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void Frustum::cullSpheres(const float* x, const float* y, const float* z, const float* radius, uint8_t* visible, size_t count) const {
+	size_t i = 0;
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4) {
+		__m128 px = _mm_loadu_ps(x + i);
+		__m128 py = _mm_loadu_ps(y + i);
+		__m128 pz = _mm_loadu_ps(z + i);
+		__m128 negRadius = _mm_sub_ps(zero, _mm_loadu_ps(radius + i));
+		__m128 inside = _mm_cmpeq_ps(zero, zero);
+		for (const glm::vec4& plane : _planes) {
+			__m128 d = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(plane.x)), _mm_mul_ps(py, _mm_set1_ps(plane.y))),
+				_mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w))
+			);
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negRadius));
+		}
+		int mask = _mm_movemask_ps(inside);
+		visible[i] = mask & 1;
+		visible[i + 1] = (mask >> 1) & 1;
+		visible[i + 2] = (mask >> 2) & 1;
+		visible[i + 3] = (mask >> 3) & 1;
+	}
+	for (; i < count; i++) {
+		visible[i] = intersectsSphere(glm::vec3(x[i], y[i], z[i]), radius[i]) ? 1 : 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <cstddef>
+
+/// <summary>
+/// The six planes of a camera's view volume, used to skip draws that can't be seen
+/// </summary>
+class Frustum {
+public:
+	/// <summary>
+	/// Extract the planes from a combined projection and view matrix
+	/// </summary>
+	/// <param name="viewProjection">The matrix taking world space to clip space</param>
+	Frustum(const glm::mat4& viewProjection);
+
+	/// <summary>
+	/// Test whether a sphere is at least partly inside the frustum
+	/// </summary>
+	/// <param name="center">The world space center</param>
+	/// <param name="radius">The world space radius</param>
+	/// <returns>False if the sphere is completely outside</returns>
+	bool intersectsSphere(const glm::vec3& center, float radius) const;
+
+	/// <summary>
+	/// Test whether a box is at least partly inside the frustum
+	/// </summary>
+	/// <param name="center">The world space center of the box</param>
+	/// <param name="extents">Half the size of the box along each world axis</param>
+	/// <returns>False if the box is completely outside</returns>
+	bool intersectsBox(const glm::vec3& center, const glm::vec3& extents) const;
+
+	/// <summary>
+	/// Test many spheres at once, four at a time with SSE.
+	/// Spheres are given as separate arrays of each component.
+	/// </summary>
+	/// <param name="x">Center x of each sphere</param>
+	/// <param name="y">Center y of each sphere</param>
+	/// <param name="z">Center z of each sphere</param>
+	/// <param name="radius">Radius of each sphere</param>
+	/// <param name="visible">Set to 1 for each sphere which intersects the frustum, 0 otherwise</param>
+	/// <param name="count">The number of spheres</param>
+	void cullSpheres(const float* x, const float* y, const float* z, const float* radius, uint8_t* visible, size_t count) const;
+private:
+	// Normals point inwards, w is the distance
+	glm::vec4 _planes[6];
+};
\ No newline at end of file
@@ -0,0 +1,402 @@
+#include "GLRenderBackend.h"
+#include "../Loading/TextLoader.h"
+#include "RenderUtil.h"
+#include "../Core/EngineMetrics.h"
+#include <algorithm>
+
+#define CAMERA_BINDING 1
+
+using std::string;
+using std::vector;
+using glm::vec3;
+
+namespace {
+	int mipLevels(int size) {
+		int levels = 1;
+		while (size > 1) {
+			size /= 2;
+			levels++;
+		}
+		return levels;
+	}
+
+	// Metric names, indexed by RenderTimer and RenderCounter
+	const char* const timerNames[] = { "frame", "gbuffer", "outline", "lighting", "ui" };
+	const char* const counterNames[] = {
+		"render.draw_calls",
+		"render.state_changes",
+		"render.upload.mesh_bytes",
+		"render.upload.instance_bytes",
+		"render.upload.light_bytes",
+		"render.upload.ui_bytes",
+		"render.upload.texture_bytes",
+		"render.upload.uniform_bytes"
+	};
+}
+
+GLRenderBackend::GLRenderBackend(Window* window, int texturePageSize, int textureLayers, const DynamicResolutionSettings& resolution)
+	: _window(window), _shader(nullptr), _texturePageSize(texturePageSize), _textureArray(nullptr),
+	_resolution(resolution), _buffer(nullptr), _atlasMemory(0), _timersRun(0) {
+	// GL calls go to whichever thread has the context current, so claim it before anything else
+	SDL_GL_MakeCurrent(_window->getSDLWindow(), _window->getContext());
+
+	initShaders();
+	initRenderBuffers();
+	initRenderGraph();
+	_meshes = new MeshRegistry();
+	_uiBatcher = new UIBatcher();
+	reserveTextureLayers(textureLayers);
+
+	glEnable(GL_FRAMEBUFFER_SRGB);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+
+	profiler.InitializeTimers(TIMER_COUNT);
+	profiler.InitializeCounters(COUNTER_COUNT);
+	profiler.LogOutput("Rendering.log");	// optional
+
+	// Timestamps are only read a frame late, so they never stall the pipeline
+	_gpuTiming = OpenGLProfiler::IsSupported();
+	if (_gpuTiming) {
+		gpuProfiler.InitializeTimers(TIMER_COUNT);
+	}
+}
+
+GLRenderBackend::~GLRenderBackend() {
+	delete _meshes;
+	delete _uiBatcher;
+	delete _textureArray;
+	delete _graph;
+	delete _emptyTarget;
+	delete _cameraUBO;
+	delete _lightBuffer;
+	delete _clusterBuffer;
+	delete _lightIndexBuffer;
+	SDL_GL_MakeCurrent(_window->getSDLWindow(), nullptr);
+}
+
+void GLRenderBackend::initShaders() {
+	loadShader("gbuffer");
+	loadShader("lighting");
+	loadShader("outline");
+	loadShader("ui");
+
+	// Block bindings are program state, so they only need setting once
+	_shaders["gbuffer"].setBindingPoint("Camera", CAMERA_BINDING);
+	_shaders["outline"].setBindingPoint("Camera", CAMERA_BINDING);
+
+	// Uniforms set per draw are looked up once here
+	_gbufferTextureRect = _shaders["gbuffer"].getUniformLocation("textureRect");
+	_gbufferTextureLayer = _shaders["gbuffer"].getUniformLocation("textureLayer");
+	_gbufferTextureMaxLod = _shaders["gbuffer"].getUniformLocation("textureMaxLod");
+}
+
+void GLRenderBackend::initRenderBuffers() {
+	const GLfloat empty[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	_emptyTarget = new GLTexture();
+	_emptyTarget->allocate(1, 1, GL_RGBA16F, empty);
+
+	_cameraUBO = new UniformBufferObject();
+
+	_lightBuffer = new TextureBufferObject(GL_RGBA32F);
+	_clusterBuffer = new TextureBufferObject(GL_RG32UI);
+	_lightIndexBuffer = new TextureBufferObject(GL_R32UI);
+}
+
+void GLRenderBackend::initRenderGraph() {
+	_graph = new RenderGraph();
+	_albedoTarget = _graph->addTarget("albedo", GL_RGBA16F);
+	_normalTarget = _graph->addTarget("normal", GL_RGBA16F);
+	_positionTarget = _graph->addTarget("position", GL_RGBA16F);
+	_depthTarget = _graph->addTarget("depth", GL_DEPTH24_STENCIL8);
+	_outlineTarget = _graph->addTarget("outline", GL_RGBA16F);
+
+	// Outlines depth test against the scene directly, lighting reads positions rather than depth
+	_gbufferPass = _graph->addPass("gbuffer", {},
+		{ _albedoTarget, _normalTarget, _positionTarget, _depthTarget },
+		[this]() { gBufferPass(); });
+	_outlinePass = _graph->addPass("outline", { _depthTarget },
+		{ _outlineTarget, _depthTarget },
+		[this]() { outlinePass(); });
+	_lightingPass = _graph->addPass("lighting", { _albedoTarget, _normalTarget, _positionTarget, _outlineTarget },
+		{ RenderGraph::BACKBUFFER },
+		[this]() { lightingPass(); });
+	_uiPass = _graph->addPass("ui", {}, { RenderGraph::BACKBUFFER },
+		[this]() { uiPass(); });
+}
+
+bool GLRenderBackend::loadShader(string shaderName) {
+	static const string shaderPath = "res/shaders/";
+	string vsh = TextLoader::load(shaderPath + shaderName + ".vsh");
+	string fsh = TextLoader::load(shaderPath + shaderName + ".fsh");
+	_shaders[shaderName] = Shader(shaderName, vsh, fsh);
+	return _shaders[shaderName].compile();
+}
+
+void GLRenderBackend::setShader(Shader& shader) {
+	if (_shader == &shader) return;
+	glUseProgram(shader.getProgram());
+	_shader = &shader;
+	profiler.AddToCounter(STATE_CHANGES);
+}
+
+void GLRenderBackend::execute(const RenderCommandBuffer& buffer) {
+	_timersRun = 0;
+	startTimer(FRAME_TIMER);
+	reserveTextureLayers(buffer.textureLayers);
+
+	// Passes only run if the frame recorded them, and then only if they have something to draw
+	_buffer = &buffer;
+	_sceneBatches.count = _outlineBatches.count = 0;
+	bool lighting = false, ui = false;
+
+	for (const RenderCommandBuffer::Command& command : buffer.commands) {
+		switch (command.type) {
+		case RenderCommandBuffer::RELEASE_MESHES:
+			for (uint32_t i = command.first; i < command.first + command.count; i++) {
+				_meshes->release(buffer.meshReleases[i]);
+			}
+			break;
+		case RenderCommandBuffer::UPLOAD_MESHES:
+			for (uint32_t i = command.first; i < command.first + command.count; i++) {
+				profiler.AddToCounter(MESH_BYTES, _meshes->upload(buffer.meshUploads[i]));
+			}
+			break;
+		case RenderCommandBuffer::UPLOAD_TEXTURES:
+			for (uint32_t i = command.first; i < command.first + command.count; i++) {
+				uploadTexture(buffer.textureUploads[i]);
+			}
+			break;
+		case RenderCommandBuffer::BEGIN_FRAME:
+			beginFrame(buffer);
+			break;
+		case RenderCommandBuffer::DRAW_SCENE:
+			_sceneBatches = command;
+			break;
+		case RenderCommandBuffer::DRAW_OUTLINES:
+			_outlineBatches = command;
+			break;
+		case RenderCommandBuffer::DRAW_LIGHTING:
+			lighting = true;
+			break;
+		case RenderCommandBuffer::DRAW_UI:
+			ui = command.count > 0;
+			break;
+		}
+	}
+
+	int width, height;
+	SDL_GL_GetDrawableSize(_window->getSDLWindow(), &width, &height);
+	_graph->setBackbufferSize(width, height);
+	_graph->setRenderScale(_resolution.getScale());
+	_graph->setPassEnabled(_gbufferPass, _sceneBatches.count > 0);
+	_graph->setPassEnabled(_outlinePass, _outlineBatches.count > 0);
+	_graph->setPassEnabled(_lightingPass, lighting);
+	_graph->setPassEnabled(_uiPass, ui);
+	_graph->compile();
+	_graph->execute();
+	// With nothing to draw, still show a cleared frame rather than whatever was left in the backbuffer
+	if (!_graph->isPassActive(_lightingPass) && !_graph->isPassActive(_uiPass)) {
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	}
+	_buffer = nullptr;
+
+	stopTimer(FRAME_TIMER);
+	publishMetrics();
+	updateRenderScale();
+	profiler.FrameFinish();
+}
+
+void GLRenderBackend::startTimer(RenderTimer timer) {
+	profiler.StartTimer(timer);
+	if (_gpuTiming) {
+		gpuProfiler.StartTimer(timer);
+	}
+	_timersRun |= 1u << timer;
+}
+
+void GLRenderBackend::stopTimer(RenderTimer timer) {
+	profiler.StopTimer(timer);
+	if (_gpuTiming) {
+		gpuProfiler.StopTimer(timer);
+	}
+}
+
+void GLRenderBackend::publishMetrics() {
+	EngineMetrics& metrics = EngineMetrics::Instance();
+	string prefix = "render.";
+	for (int i = 0; i < TIMER_COUNT; i++) {
+		bool ran = (_timersRun & (1u << i)) != 0;
+		metrics.Set(prefix + timerNames[i] + ".cpu_ms", ran ? profiler.GetDurationSec(i) * 1000.0 : 0.0);
+	}
+	if (_gpuTiming) {
+		// These are the previous frame's timestamps, which are usually done by now
+		gpuProfiler.FrameFinish();
+		for (int i = 0; i < TIMER_COUNT; i++) {
+			if (gpuProfiler.IsReady(i)) {
+				metrics.Set(prefix + timerNames[i] + ".gpu_ms", gpuProfiler.GetDuration(i) / 1000000.0);
+			}
+		}
+	}
+	for (int i = 0; i < COUNTER_COUNT; i++) {
+		metrics.Set(counterNames[i], (double)profiler.GetCounter(i));
+	}
+	metrics.Set("render.texture_memory_bytes", (double)(_atlasMemory + _graph->getTargetMemory()));
+	metrics.Set("render.resolution_scale", _resolution.getScale());
+}
+
+void GLRenderBackend::updateRenderScale() {
+	// The GPU time is what the resolution changes, the CPU time of the frame only stands in without timer queries.
+	// GPU timings are a frame behind, so they still describe the scale from before the last change for a frame,
+	// which the controller's settle time covers.
+	double frameMs = profiler.GetDurationSec(FRAME_TIMER) * 1000.0;
+	if (_gpuTiming) {
+		frameMs = gpuProfiler.IsReady(FRAME_TIMER) ? gpuProfiler.GetDuration(FRAME_TIMER) / 1000000.0 : 0.0;
+	}
+	_resolution.update(frameMs);
+}
+
+void GLRenderBackend::present() {
+	SDL_GL_SwapWindow(_window->getSDLWindow());
+}
+
+void GLRenderBackend::reserveTextureLayers(int layers) {
+	if (_textureArray != nullptr && layers <= _textureArray->getLayers()) return;
+	int capacity = _textureArray != nullptr ? std::max(layers, _textureArray->getLayers() * 2) : std::max(layers, 1);
+
+	// Texture storage is immutable, so grow into a new array and copy the old layers across on the GPU
+	GLTextureArray* previous = _textureArray;
+	_textureArray = new GLTextureArray(_texturePageSize, _texturePageSize, capacity, mipLevels(_texturePageSize), GL_SRGB8_ALPHA8);
+	if (previous != nullptr) {
+		_textureArray->copyLayers(*previous);
+		delete previous;
+	}
+	_atlasMemory = 0;
+	for (int size = _texturePageSize; size > 0; size /= 2) {
+		_atlasMemory += (size_t)size * size * 4 * capacity;
+	}
+}
+
+void GLRenderBackend::uploadTexture(const TextureUpload& upload) {
+	for (size_t i = 0; i < upload.levels.size(); i++) {
+		const MipLevel& level = upload.levels[i];
+		_textureArray->setSubImage(upload.layer, i, upload.x >> i, upload.y >> i, level.width, level.height, &level.pixels[0]);
+		profiler.AddToCounter(TEXTURE_BYTES, level.pixels.size());
+	}
+}
+
+void GLRenderBackend::beginFrame(const RenderCommandBuffer& buffer) {
+	// The render graph clears each target before the first pass that writes it
+	CameraData camera = buffer.camera;
+	_cameraUBO->buffer(camera);
+	_cameraUBO->bind(CAMERA_BINDING);
+	profiler.AddToCounter(UNIFORM_BYTES, sizeof(CameraData));
+
+	// Scene and outline batches index into the same instances
+	_meshes->bufferInstances(buffer.instances);
+	profiler.AddToCounter(INSTANCE_BYTES, buffer.instances.size() * sizeof(InstanceData));
+}
+
+void GLRenderBackend::gBufferPass() {
+	startTimer(GBUFFER_TIMER);
+	setShader(_shaders["gbuffer"]);
+	_meshes->bind();
+
+	_textureArray->bind(GL_TEXTURE0);
+	_shader->setUniformTexture("albedoTex", 0);
+
+	drawBatches(*_buffer, _sceneBatches.first, _sceneBatches.count, true);
+	stopTimer(GBUFFER_TIMER);
+}
+
+void GLRenderBackend::drawBatches(const RenderCommandBuffer& buffer, uint32_t first, uint32_t count, bool bindTextures) {
+	const TextureRegion* lastTexture = nullptr;
+	for (uint32_t i = first; i < first + count; i++) {
+		const DrawBatch& batch = buffer.batches[i];
+		if (bindTextures && (lastTexture == nullptr || batch.texture.rect != lastTexture->rect || batch.texture.layer != lastTexture->layer)) {
+			_shader->setUniformVec4(_gbufferTextureRect, batch.texture.rect);
+			_shader->setUniformFloat(_gbufferTextureLayer, batch.texture.layer);
+			_shader->setUniformFloat(_gbufferTextureMaxLod, batch.texture.maxLod);
+			lastTexture = &batch.texture;
+			profiler.AddToCounter(STATE_CHANGES);
+		}
+		_meshes->drawInstanced(_meshes->get(batch.meshID), batch.firstInstance, batch.instanceCount);
+		profiler.AddToCounter(DRAW_CALLS);
+	}
+}
+
+void GLRenderBackend::outlinePass() {
+	startTimer(OUTLINE_TIMER);
+	setShader(_shaders["outline"]);
+
+	glCullFace(GL_FRONT);
+
+	// Outlines extrude along the smooth normals stored next to the mesh,
+	// the instance color's alpha is the line width
+	_meshes->bind();
+	drawBatches(*_buffer, _outlineBatches.first, _outlineBatches.count, false);
+	glCullFace(GL_BACK);
+	stopTimer(OUTLINE_TIMER);
+}
+
+void GLRenderBackend::bindTarget(int target, GLenum slot) {
+	GLTexture* texture = _graph->getTexture(target);
+	(texture != nullptr ? texture : _emptyTarget)->bind(slot);
+}
+
+void GLRenderBackend::lightingPass() {
+	startTimer(LIGHTING_TIMER);
+	const RenderCommandBuffer& buffer = *_buffer;
+	const LightingParams& params = buffer.lighting;
+	setShader(_shaders["lighting"]);
+	_meshes->bind();
+
+	bindTarget(_albedoTarget, GL_TEXTURE0);
+	bindTarget(_normalTarget, GL_TEXTURE1);
+	bindTarget(_positionTarget, GL_TEXTURE2);
+	bindTarget(_outlineTarget, GL_TEXTURE3);
+
+	_shader->setUniformTexture("albedoTex", 0);
+	_shader->setUniformTexture("normalTex", 1);
+	_shader->setUniformTexture("positionTex", 2);
+	_shader->setUniformTexture("outlineTex", 3);
+
+	_shader->setUniformVec3("ambientColor", params.ambientColor);
+
+	// Every pixel shades the global lights, then the lights binned into its cluster
+	_lightBuffer->stream(buffer.lights.empty() ? nullptr : &buffer.lights[0], buffer.lights.size() * sizeof(LightData));
+	_clusterBuffer->stream(buffer.clusterRanges.empty() ? nullptr : &buffer.clusterRanges[0], buffer.clusterRanges.size() * sizeof(uint32_t));
+	_lightIndexBuffer->stream(buffer.lightIndices.empty() ? nullptr : &buffer.lightIndices[0], buffer.lightIndices.size() * sizeof(uint32_t));
+	_lightBuffer->bind(GL_TEXTURE4);
+	_clusterBuffer->bind(GL_TEXTURE5);
+	profiler.AddToCounter(LIGHT_BYTES, buffer.lights.size() * sizeof(LightData)
+		+ (buffer.clusterRanges.size() + buffer.lightIndices.size()) * sizeof(uint32_t));
+	_lightIndexBuffer->bind(GL_TEXTURE6);
+	_shader->setUniformTexture("lightData", 4);
+	_shader->setUniformTexture("clusterRanges", 5);
+	_shader->setUniformTexture("lightIndices", 6);
+	_shader->setUniformInt("numGlobalLights", params.globalLights);
+	_shader->setUniformVec3("clusterGrid", params.clusterGrid);
+	_shader->setUniformFloat("clusterDepthScale", params.clusterDepthScale);
+	_shader->setUniformFloat("clusterDepthBias", params.clusterDepthBias);
+
+	_meshes->draw(_meshes->get(params.quadMeshID));
+	profiler.AddToCounter(DRAW_CALLS);
+	stopTimer(LIGHTING_TIMER);
+}
+
+void GLRenderBackend::uiPass() {
+	startTimer(UI_TIMER);
+	const RenderCommandBuffer& buffer = *_buffer;
+	glClear(GL_DEPTH_BUFFER_BIT);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	setShader(_shaders["ui"]);
+	_textureArray->bind(GL_TEXTURE0);
+	_shader->setUniformTexture("tex", 0);
+
+	profiler.AddToCounter(DRAW_CALLS, _uiBatcher->draw(buffer.uiVertices, buffer.uiIndices));
+	profiler.AddToCounter(UI_BYTES, buffer.uiVertices.size() * sizeof(UIVertex) + buffer.uiIndices.size() * sizeof(GLuint));
+	glDisable(GL_BLEND);
+	stopTimer(UI_TIMER);
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+#include "RenderBackend.h"
+#include "Window.h"
+#include "Shader.h"
+#include "MeshRegistry.h"
+#include "UIBatcher.h"
+#include "GLTexture.h"
+#include "GLTextureArray.h"
+#include "RenderGraph.h"
+#include "DynamicResolution.h"
+#include "BufferObjects/UniformBufferObject.h"
+#include "BufferObjects/TextureBufferObject.h"
+#include "../Util/CpuProfiler.h"
+#include "../Util/OpenGLProfiler.h"
+#include <map>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Replays frames with OpenGL 3.3 through the deferred pipeline:
+/// gbuffer, outlines, clustered lighting, then the UI on top.
+/// Owns the window's GL context, so it must be created and used on one thread only.
+/// </summary>
+class GLRenderBackend : public RenderBackend {
+public:
+	/// <summary>
+	/// Take the window's context on the calling thread and create every GL resource
+	/// </summary>
+	/// <param name="window">The window to draw to, its context must not be current anywhere else</param>
+	/// <param name="texturePageSize">The width and height of the texture atlas layers</param>
+	/// <param name="textureLayers">The atlas layers to allocate up front</param>
+	/// <param name="resolution">How far the scene may drop below the window's resolution to stay within its frame time</param>
+	GLRenderBackend(Window* window, int texturePageSize, int textureLayers, const DynamicResolutionSettings& resolution);
+	~GLRenderBackend();
+
+	void execute(const RenderCommandBuffer& buffer) override;
+	void present() override;
+private:
+	// Profiler timers, a pass uses the same index for its CPU and GPU timer
+	enum RenderTimer {
+		FRAME_TIMER = 0,
+		GBUFFER_TIMER,
+		OUTLINE_TIMER,
+		LIGHTING_TIMER,
+		UI_TIMER,
+		TIMER_COUNT
+	};
+
+	// Profiler counters, bytes are what was copied to the GPU this frame
+	enum RenderCounter {
+		DRAW_CALLS = 0,
+		STATE_CHANGES,
+		MESH_BYTES,
+		INSTANCE_BYTES,
+		LIGHT_BYTES,
+		UI_BYTES,
+		TEXTURE_BYTES,
+		UNIFORM_BYTES,
+		COUNTER_COUNT
+	};
+
+	bool loadShader(std::string shaderName);
+	void initShaders();
+	void initRenderBuffers();
+	void initRenderGraph();
+	void setShader(Shader& s);
+	void reserveTextureLayers(int layers);
+	void uploadTexture(const TextureUpload& upload);
+	void beginFrame(const RenderCommandBuffer& buffer);
+	void gBufferPass();
+	void outlinePass();
+	void lightingPass();
+	void uiPass();
+	void bindTarget(int target, GLenum slot);
+	void drawBatches(const RenderCommandBuffer& buffer, uint32_t first, uint32_t count, bool bindTextures);
+	void startTimer(RenderTimer timer);
+	void stopTimer(RenderTimer timer);
+	void publishMetrics();
+	void updateRenderScale();
+
+	Window* _window;
+	std::map<std::string, Shader> _shaders;
+	Shader* _shader;
+
+	// Cached uniform locations
+	GLint _gbufferTextureRect;
+	GLint _gbufferTextureLayer;
+	GLint _gbufferTextureMaxLod;
+
+	MeshRegistry* _meshes;
+	UIBatcher* _uiBatcher;
+
+	// The atlas storage is immutable, so growing it copies the old layers into a larger array
+	int _texturePageSize;
+	GLTextureArray* _textureArray;
+
+	// The passes and the targets between them, sized to the window times the render scale
+	RenderGraph* _graph;
+	DynamicResolution _resolution;
+	int _albedoTarget;
+	int _normalTarget;
+	int _positionTarget;
+	int _depthTarget;
+	int _outlineTarget;
+	int _gbufferPass;
+	int _outlinePass;
+	int _lightingPass;
+	int _uiPass;
+	// Bound in place of targets whose pass was culled, reads as transparent black
+	GLTexture* _emptyTarget;
+
+	// The frame being executed and the batch ranges its passes draw
+	const RenderCommandBuffer* _buffer;
+	RenderCommandBuffer::Command _sceneBatches;
+	RenderCommandBuffer::Command _outlineBatches;
+
+	UniformBufferObject* _cameraUBO;
+	TextureBufferObject* _lightBuffer;
+	TextureBufferObject* _clusterBuffer;
+	TextureBufferObject* _lightIndexBuffer;
+
+	// Bytes of texture memory held by the atlas
+	size_t _atlasMemory;
+
+	CpuProfiler profiler;
+	OpenGLProfiler gpuProfiler;
+	bool _gpuTiming;
+	// Bit per timer that ran this frame, timers that didn't report 0
+	unsigned int _timersRun;
+};
\ No newline at end of file
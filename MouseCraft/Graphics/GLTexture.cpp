@@ -52,6 +52,27 @@ void GLTexture::setImage(Image& image, bool mipmap, GLuint storageFormat, GLuint
 	}
 }
 
+void GLTexture::allocate(int width, int height, GLuint storageFormat, const GLfloat* pixels) {
+	glBindTexture(GL_TEXTURE_2D, _id);
+	RenderUtil::checkGLError("glBindTexture");
+	bool depth = storageFormat == GL_DEPTH24_STENCIL8 || storageFormat == GL_DEPTH_COMPONENT24 || storageFormat == GL_DEPTH_COMPONENT32F;
+	if (depth) {
+		GLenum format = storageFormat == GL_DEPTH24_STENCIL8 ? GL_DEPTH_STENCIL : GL_DEPTH_COMPONENT;
+		GLenum type = storageFormat == GL_DEPTH24_STENCIL8 ? GL_UNSIGNED_INT_24_8 : GL_FLOAT;
+		glTexImage2D(GL_TEXTURE_2D, 0, storageFormat, width, height, 0, format, type, nullptr);
+	}
+	else {
+		glTexImage2D(GL_TEXTURE_2D, 0, storageFormat, width, height, 0, GL_RGBA, GL_FLOAT, pixels);
+	}
+	RenderUtil::checkGLError("glTexImage2D");
+	// Targets are sampled one texel per pixel, so nothing past level 0 is needed
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, depth ? GL_NEAREST : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, depth ? GL_NEAREST : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
 void GLTexture::bind(GLenum slot) {
 	glActiveTexture(slot);
 	glBindTexture(GL_TEXTURE_2D, _id);
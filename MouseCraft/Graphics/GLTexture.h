@@ -12,6 +12,9 @@ public:
 		GLuint storageFormat = GL_RGBA16F,
 		GLuint inputType = GL_FLOAT
 	);
+	// Give the texture storage to render into, with no mipmaps.
+	// Depth formats get depth-stencil storage, anything else is read as RGBA floats from pixels if given.
+	void allocate(int width, int height, GLuint storageFormat, const GLfloat* pixels = nullptr);
 	void bind(GLenum slot);
 	void unbind(GLenum slot);
 private:
@@ -1,5 +1,6 @@
 #include "GLTextureArray.h"
 #include "RenderUtil.h"
+#include <algorithm>
 GLTextureArray::GLTextureArray(int width, int height, int layers, int mipmapLevels, GLuint storageFormat)
 : _width(width), _height(height), _layers(layers), _mipmaps(mipmapLevels) {
 	glGenTextures(1, &_id);
@@ -58,6 +59,25 @@ void GLTextureArray::setImage(int layer, Image& image, GLuint inputType) {
 	RenderUtil::checkGLError("glTexSubImage3D");
 }
 
+void GLTextureArray::setSubImage(int layer, int level, int x, int y, int width, int height,
+	const void* data, GLuint inputFormat, GLuint inputType) {
+	glBindTexture(GL_TEXTURE_2D_ARRAY, _id);
+	glTexSubImage3D(
+		GL_TEXTURE_2D_ARRAY,
+		level,
+		x,
+		y,
+		layer,
+		width,
+		height,
+		1,
+		inputFormat,
+		inputType,
+		data
+	);
+	RenderUtil::checkGLError("glTexSubImage3D");
+}
+
 void GLTextureArray::bind(GLenum slot) {
 	glActiveTexture(slot);
 	glBindTexture(GL_TEXTURE_2D_ARRAY, _id);
@@ -69,6 +89,40 @@ void GLTextureArray::genMipmaps() {
 	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
 }
 
+void GLTextureArray::copyLayers(GLTextureArray& source) {
+	int layers = std::min(_layers, source.getLayers());
+	int levels = std::min(_mipmaps, source.getMipmaps());
+	if (GLAD_GL_ARB_copy_image) {
+		for (int level = 0; level < levels; level++) {
+			glCopyImageSubData(
+				source.getID(), GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+				_id, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+				std::max(source.getWidth() >> level, 1), std::max(source.getHeight() >> level, 1), layers
+			);
+		}
+		RenderUtil::checkGLError("glCopyImageSubData");
+		return;
+	}
+
+	// Otherwise read each layer and level through a framebuffer
+	GLint previous;
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous);
+	GLuint fbo;
+	glGenFramebuffers(1, &fbo);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, _id);
+	for (int layer = 0; layer < layers; layer++) {
+		for (int level = 0; level < levels; level++) {
+			glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, source.getID(), level, layer);
+			glCopyTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, 0, 0,
+				std::max(source.getWidth() >> level, 1), std::max(source.getHeight() >> level, 1));
+		}
+	}
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, previous);
+	glDeleteFramebuffers(1, &fbo);
+	RenderUtil::checkGLError("glCopyTexSubImage3D");
+}
+
 void GLTextureArray::unbind(GLenum slot) {
 	glActiveTexture(slot);
 	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
@@ -87,6 +141,10 @@ int GLTextureArray::getLayers() {
 	return _layers;
 }
 
+int GLTextureArray::getMipmaps() {
+	return _mipmaps;
+}
+
 GLuint GLTextureArray::getID() {
 	return _id;
 }
\ No newline at end of file
@@ -11,12 +11,26 @@ public:
 		Image& image,
 		GLuint inputType = GL_FLOAT
 	);
+	void setSubImage(
+		int layer,
+		int level,
+		int x,
+		int y,
+		int width,
+		int height,
+		const void* data,
+		GLuint inputFormat = GL_RGBA,
+		GLuint inputType = GL_UNSIGNED_BYTE
+	);
 	void bind(GLenum slot);
 	void unbind(GLenum slot);
 	void genMipmaps();
+	// Copies every level of the source's layers into the same layers here, without leaving the GPU
+	void copyLayers(GLTextureArray& source);
 	int getWidth();
 	int getHeight();
 	int getLayers();
+	int getMipmaps();
 private:
 	GLuint _id;
 	int _layers;
@@ -1,6 +1,11 @@
 #pragma once
 #include "../GL/glad.h"
+#include "VertexFormat.h"
+#include "MeshIDPool.h"
+#include <glm/glm.hpp>
 #include <vector>
+#include <memory>
+#include <algorithm>
 
 /// <summary>
 /// A basic model geometry containing vertex data, normal data, texture coordinates, and face indices.
@@ -13,9 +18,9 @@ public:
 	Geometry() = default;
 
 	/// <summary>
-	/// Default destructor
+	/// Gives the mesh ID back so the renderer can reuse it and its arena space
 	/// </summary>
-	~Geometry() = default;
+	~Geometry() { MeshIDPool::instance().release(_meshID); }
 
 	/// <summary>
 	/// Get the vertex data of the shape
@@ -27,7 +32,7 @@ public:
 	/// Set the vertex data of the shape
 	/// </summary>
 	/// <param name="vertexData">The vertex data as an array of GLfloats (3 per coodinate)</param>
-	void setVertexData(std::vector<GLfloat>& vertexData) { _vertexData = vertexData; }
+	void setVertexData(std::vector<GLfloat>& vertexData) { _vertexData = vertexData; changed(); calcBounds(); }
 
 	/// <summary>
 	/// Get the normal data of the shape
@@ -39,7 +44,20 @@ public:
 	/// Set the normal data of the shape
 	/// </summary>
 	/// <param name="normalData">The normal data as an array of GLfloats (3 per coordinate)</param>
-	void setNormalData(std::vector<GLfloat>& normalData) { _normalData = normalData; }
+	void setNormalData(std::vector<GLfloat>& normalData) { _normalData = normalData; changed(); }
+
+	/// <summary>
+	/// Get the smooth normals of the shape, shared by every vertex at the same position.
+	/// Outlines extrude along these. Empty unless generated at load time.
+	/// </summary>
+	/// <returns>The smooth normals as an array of GLfloats (3 per coordinate)</returns>
+	std::vector<GLfloat>& getSmoothNormalData() { return _smoothNormalData; }
+
+	/// <summary>
+	/// Set the smooth normals of the shape
+	/// </summary>
+	/// <param name="smoothNormalData">The smooth normals as an array of GLfloats (3 per coordinate)</param>
+	void setSmoothNormalData(std::vector<GLfloat>& smoothNormalData) { _smoothNormalData = smoothNormalData; changed(); }
 
 	/// <summary>
 	/// Get the texture coordinate data of the shape
@@ -51,7 +69,7 @@ public:
 	/// Set the texture coordinate data of the shape
 	/// </summary>
 	/// <param name="texCoordData">The texture coordinate data as an array of GLfloats (2 per coordinate)</param>
-	void setTexCoordData(std::vector<GLfloat>& texCoordData) { _texCoordData = texCoordData; }
+	void setTexCoordData(std::vector<GLfloat>& texCoordData) { _texCoordData = texCoordData; changed(); }
 
 	/// <summary>
 	/// Get the face indices of the shape
@@ -63,8 +81,117 @@ public:
 	/// Set the face indices of the shape
 	/// </summary>
 	/// <param name="indices">The face indices as an array of GLuints (3 per triangle)</param>
-	void setIndices(std::vector<GLuint>& indices) { _indices = indices; }
+	void setIndices(std::vector<GLuint>& indices) { _indices = indices; changed(); }
+
+	/// <summary>
+	/// Get the slot of this geometry in the renderer's mesh arena.
+	/// Any of the setters above clear it, so changed geometry is uploaded again.
+	/// </summary>
+	/// <returns>The mesh ID, or -1 if the geometry is not resident on the GPU</returns>
+	int getMeshID() { return _meshID; }
+
+	/// <summary>
+	/// Set the slot of this geometry in the renderer's mesh arena
+	/// </summary>
+	/// <param name="id">The mesh ID assigned by the RenderSystem</param>
+	void setMeshID(int id) { _meshID = id; }
+
+	/// <summary>
+	/// Convert the float arrays to the renderer's compact interleaved layout.
+	/// Loaders call this once at import so recording a frame never has to.
+	/// </summary>
+	void pack() { VertexFormat::pack(*this, _packed); }
+
+	/// <summary>
+	/// Get the geometry in the renderer's compact interleaved layout,
+	/// packing it first if it hasn't been since the last change
+	/// </summary>
+	/// <returns>The packed vertices and indices</returns>
+	const PackedMesh& getPackedMesh() {
+		if (_packed.indexCount == 0 && !_indices.empty()) pack();
+		return _packed;
+	}
+
+	/// <summary>
+	/// Get the smallest corner of the axis aligned bounding box.
+	/// Bounds are calculated whenever the vertex data is set.
+	/// </summary>
+	/// <returns>The minimum x, y and z of every vertex</returns>
+	const glm::vec3& getBoundsMin() { return _boundsMin; }
+
+	/// <summary>
+	/// Get the largest corner of the axis aligned bounding box
+	/// </summary>
+	/// <returns>The maximum x, y and z of every vertex</returns>
+	const glm::vec3& getBoundsMax() { return _boundsMax; }
+
+	/// <summary>
+	/// Get the center of the bounding sphere, which is the center of the bounding box
+	/// </summary>
+	/// <returns>The bounding sphere center in model space</returns>
+	const glm::vec3& getBoundsCenter() { return _boundsCenter; }
+
+	/// <summary>
+	/// Get the radius of the bounding sphere
+	/// </summary>
+	/// <returns>The distance from the center to the furthest vertex</returns>
+	float getBoundsRadius() { return _boundsRadius; }
+
+	/// <summary>
+	/// Get the number of detail levels, counting this geometry as level 0
+	/// </summary>
+	/// <returns>1 plus the number of simplified versions attached</returns>
+	int getLODCount() { return 1 + (int)_lods.size(); }
+
+	/// <summary>
+	/// Get a detail level of this geometry. Levels past the last return the last.
+	/// </summary>
+	/// <param name="level">0 for this geometry, higher for fewer triangles</param>
+	/// <returns>The geometry to draw at that level</returns>
+	Geometry* getLOD(int level) {
+		if (level <= 0 || _lods.empty()) return this;
+		return _lods[std::min((size_t)level, _lods.size()) - 1].get();
+	}
+
+	/// <summary>
+	/// Attach the next simplified version of this geometry. Takes ownership.
+	/// </summary>
+	/// <param name="lod">A geometry with fewer triangles than the last level</param>
+	void addLOD(Geometry* lod) { _lods.emplace_back(lod); }
 private:
+	/// <summary>
+	/// Release the uploaded and packed copies after any of the data changes
+	/// </summary>
+	void changed() {
+		MeshIDPool::instance().release(_meshID);
+		_meshID = -1;
+		_packed.clear();
+	}
+
+	/// <summary>
+	/// Recalculate the bounding box and sphere from the vertex data
+	/// </summary>
+	void calcBounds() {
+		if (_vertexData.size() < 3) {
+			_boundsMin = _boundsMax = _boundsCenter = glm::vec3(0.0f);
+			_boundsRadius = 0.0f;
+			return;
+		}
+		_boundsMin = _boundsMax = glm::vec3(_vertexData[0], _vertexData[1], _vertexData[2]);
+		for (size_t i = 3; i + 2 < _vertexData.size(); i += 3) {
+			glm::vec3 v(_vertexData[i], _vertexData[i + 1], _vertexData[i + 2]);
+			_boundsMin = glm::min(_boundsMin, v);
+			_boundsMax = glm::max(_boundsMax, v);
+		}
+		_boundsCenter = (_boundsMin + _boundsMax) * 0.5f;
+		float radiusSquared = 0.0f;
+		for (size_t i = 0; i + 2 < _vertexData.size(); i += 3) {
+			glm::vec3 d = glm::vec3(_vertexData[i], _vertexData[i + 1], _vertexData[i + 2]) - _boundsCenter;
+			radiusSquared = std::max(radiusSquared, glm::dot(d, d));
+		}
+		_boundsRadius = sqrtf(radiusSquared);
+	}
+
 	/// <summary>
 	/// An array of vertex data. Each vertex is stored across 3 indices in the array.
 	/// </summary>
@@ -75,6 +202,11 @@ private:
 	/// </summary>
 	std::vector<GLfloat> _normalData;
 
+	/// <summary>
+	/// An array of smooth normals matching _normalData, or empty if none were generated.
+	/// </summary>
+	std::vector<GLfloat> _smoothNormalData;
+
 	/// <summary>
 	/// An array of texture coordinate data. Each texture coordinate is stored across 2 indices in the array.
 	/// </summary>
@@ -84,5 +216,28 @@ private:
 	/// The indices which define the triangles in the model. Each triangle face is 3 indices.
 	/// </summary>
 	std::vector<GLuint> _indices;
+
+	/// <summary>
+	/// The slot of this geometry in the renderer's mesh arena, -1 if not uploaded.
+	/// </summary>
+	int _meshID = -1;
+
+	/// <summary>
+	/// The data in the renderer's layout, empty until packed
+	/// </summary>
+	PackedMesh _packed = PackedMesh{ {}, {}, GL_UNSIGNED_INT, 0 };
+
+	/// <summary>
+	/// The model space bounding box and sphere
+	/// </summary>
+	glm::vec3 _boundsMin = glm::vec3(0.0f);
+	glm::vec3 _boundsMax = glm::vec3(0.0f);
+	glm::vec3 _boundsCenter = glm::vec3(0.0f);
+	float _boundsRadius = 0.0f;
+
+	/// <summary>
+	/// Simplified versions of this geometry, from most to least detailed
+	/// </summary>
+	std::vector<std::unique_ptr<Geometry>> _lods;
 };
 
@@ -0,0 +1,148 @@
+#include "LightClusters.h"
+#include "../Core/TaskScheduler.h"
+#include <xmmintrin.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using std::vector;
+using glm::vec4;
+using glm::mat4;
+
+LightClusters::LightClusters(int tilesX, int tilesY, int slices)
+	: _tilesX(tilesX), _tilesY(tilesY), _slices(slices), _projection(0.0f),
+	_nearClip(0.0f), _farClip(0.0f), _depthScale(0.0f), _depthBias(0.0f) {
+	_sliceStride = (_tilesX * _tilesY + 3) & ~3;
+	size_t count = _sliceStride * _slices;
+	_minX.assign(count, FLT_MAX);
+	_minY.assign(count, FLT_MAX);
+	_minZ.assign(count, FLT_MAX);
+	_maxX.assign(count, -FLT_MAX);
+	_maxY.assign(count, -FLT_MAX);
+	_maxZ.assign(count, -FLT_MAX);
+}
+
+void LightClusters::setProjection(const mat4& projection, float nearClip, float farClip) {
+	if (projection == _projection && nearClip == _nearClip && farClip == _farClip) return;
+	_projection = projection;
+	_nearClip = nearClip;
+	_farClip = farClip;
+	_depthScale = _slices / logf(farClip / nearClip);
+	_depthBias = -logf(nearClip) * _depthScale;
+
+	// A view space point at depth d lands on ndc x * d / projection[0][0], likewise for y
+	for (int s = 0; s < _slices; s++) {
+		float sliceNear = nearClip * powf(farClip / nearClip, (float)s / _slices);
+		float sliceFar = nearClip * powf(farClip / nearClip, (float)(s + 1) / _slices);
+		for (int y = 0; y < _tilesY; y++) {
+			float ndcY0 = -1.0f + 2.0f * y / _tilesY;
+			float ndcY1 = -1.0f + 2.0f * (y + 1) / _tilesY;
+			for (int x = 0; x < _tilesX; x++) {
+				float ndcX0 = -1.0f + 2.0f * x / _tilesX;
+				float ndcX1 = -1.0f + 2.0f * (x + 1) / _tilesX;
+				size_t i = s * _sliceStride + y * _tilesX + x;
+				_minX[i] = std::min(ndcX0 * sliceNear, ndcX0 * sliceFar) / projection[0][0];
+				_maxX[i] = std::max(ndcX1 * sliceNear, ndcX1 * sliceFar) / projection[0][0];
+				_minY[i] = std::min(ndcY0 * sliceNear, ndcY0 * sliceFar) / projection[1][1];
+				_maxY[i] = std::max(ndcY1 * sliceNear, ndcY1 * sliceFar) / projection[1][1];
+				_minZ[i] = -sliceFar;
+				_maxZ[i] = -sliceNear;
+			}
+		}
+	}
+}
+
+void LightClusters::bin(const vector<vec4>& spheres, uint32_t firstIndex, vector<uint32_t>& ranges, vector<uint32_t>& indices) {
+	ranges.assign(_tilesX * _tilesY * _slices * 2, 0);
+	indices.clear();
+	if (spheres.empty()) return;
+
+	TaskScheduler& scheduler = TaskScheduler::instance();
+	size_t chunkCount = scheduler.ChunkCount(_slices, 1);
+	if (_chunks.size() < chunkCount) {
+		_chunks.resize(chunkCount);
+	}
+	scheduler.ParallelFor(_slices, 1, [&](size_t begin, size_t end, size_t chunk) {
+		binSlices(spheres, firstIndex, begin, end, ranges, _chunks[chunk]);
+	});
+
+	// Chunks cover consecutive slices, so their lists append in cluster order
+	for (size_t c = 0; c < chunkCount; c++) {
+		// Offsets were written relative to the chunk's own list
+		uint32_t base = indices.size();
+		uint32_t lastCluster = UINT32_MAX;
+		for (const auto& hit : _chunks[c].hits) {
+			if (hit.first != lastCluster) {
+				ranges[hit.first * 2] += base;
+				lastCluster = hit.first;
+			}
+		}
+		indices.insert(indices.end(), _chunks[c].indices.begin(), _chunks[c].indices.end());
+	}
+}
+
+void LightClusters::binSlices(const vector<vec4>& spheres, uint32_t firstIndex, int sliceBegin, int sliceEnd,
+	vector<uint32_t>& ranges, SliceChunk& chunk) {
+	chunk.hits.clear();
+	chunk.indices.clear();
+
+	for (size_t l = 0; l < spheres.size(); l++) {
+		const vec4& sphere = spheres[l];
+		float depth = -sphere.z;
+		if (depth + sphere.w < _nearClip || depth - sphere.w > _farClip) continue;
+		int first = std::max(sliceOf(depth - sphere.w), sliceBegin);
+		int last = std::min(sliceOf(depth + sphere.w), sliceEnd - 1);
+
+		__m128 cx = _mm_set1_ps(sphere.x);
+		__m128 cy = _mm_set1_ps(sphere.y);
+		__m128 cz = _mm_set1_ps(sphere.z);
+		__m128 r2 = _mm_set1_ps(sphere.w * sphere.w);
+		__m128 zero = _mm_setzero_ps();
+		for (int s = first; s <= last; s++) {
+			// Distance from the center to each of four cluster boxes at once
+			for (int i = s * _sliceStride; i < (s + 1) * _sliceStride; i += 4) {
+				__m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&_minX[i]), cx), _mm_sub_ps(cx, _mm_loadu_ps(&_maxX[i]))), zero);
+				__m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&_minY[i]), cy), _mm_sub_ps(cy, _mm_loadu_ps(&_maxY[i]))), zero);
+				__m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&_minZ[i]), cz), _mm_sub_ps(cz, _mm_loadu_ps(&_maxZ[i]))), zero);
+				__m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+				int mask = _mm_movemask_ps(_mm_cmple_ps(d2, r2));
+				while (mask != 0) {
+					int lane = 0;
+					while (!(mask & (1 << lane))) lane++;
+					mask &= ~(1 << lane);
+					int tile = i + lane - s * _sliceStride;
+					chunk.hits.push_back(std::make_pair((uint32_t)(s * _tilesX * _tilesY + tile), (uint32_t)(firstIndex + l)));
+				}
+			}
+		}
+	}
+
+	// Group the hits by cluster, lights stay in order within a cluster
+	std::stable_sort(chunk.hits.begin(), chunk.hits.end(),
+		[](const std::pair<uint32_t, uint32_t>& a, const std::pair<uint32_t, uint32_t>& b) { return a.first < b.first; });
+	for (size_t i = 0; i < chunk.hits.size(); i++) {
+		uint32_t cluster = chunk.hits[i].first;
+		if (i == 0 || chunk.hits[i - 1].first != cluster) {
+			ranges[cluster * 2] = chunk.indices.size();
+		}
+		ranges[cluster * 2 + 1]++;
+		chunk.indices.push_back(chunk.hits[i].second);
+	}
+}
+
+int LightClusters::sliceOf(float depth) {
+	if (depth <= _nearClip) return 0;
+	return std::min(std::max((int)floorf(logf(depth) * _depthScale + _depthBias), 0), _slices - 1);
+}
+
+glm::vec3 LightClusters::getGrid() {
+	return glm::vec3(_tilesX, _tilesY, _slices);
+}
+
+float LightClusters::getDepthScale() {
+	return _depthScale;
+}
+
+float LightClusters::getDepthBias() {
+	return _depthBias;
+}
\ No newline at end of file
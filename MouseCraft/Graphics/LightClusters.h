@@ -0,0 +1,87 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Splits the view frustum into a grid of screen tiles and exponential depth slices,
+/// and bins lights into the clusters their sphere of influence touches.
+/// The lighting shader looks up its pixel's cluster and only shades that cluster's lights.
+/// </summary>
+class LightClusters {
+public:
+	/// <summary>
+	/// Create the cluster grid
+	/// </summary>
+	/// <param name="tilesX">The number of tiles across the screen</param>
+	/// <param name="tilesY">The number of tiles down the screen</param>
+	/// <param name="slices">The number of depth slices between the clip planes</param>
+	LightClusters(int tilesX, int tilesY, int slices);
+
+	/// <summary>
+	/// Recalculate the view space bounds of every cluster. Does nothing if the projection didn't change.
+	/// </summary>
+	/// <param name="projection">A symmetric perspective projection</param>
+	/// <param name="nearClip">The distance to the near plane</param>
+	/// <param name="farClip">The distance to the far plane</param>
+	void setProjection(const glm::mat4& projection, float nearClip, float farClip);
+
+	/// <summary>
+	/// Find the lights touching each cluster. Slices are binned in parallel on the task scheduler.
+	/// </summary>
+	/// <param name="spheres">View space center in xyz and radius in w of each light</param>
+	/// <param name="firstIndex">Added to the position in spheres to get the index written out</param>
+	/// <param name="ranges">Receives the offset and count into indices of each cluster</param>
+	/// <param name="indices">Receives every cluster's light indices back to back</param>
+	void bin(const std::vector<glm::vec4>& spheres, uint32_t firstIndex,
+		std::vector<uint32_t>& ranges, std::vector<uint32_t>& indices);
+
+	/// <summary>
+	/// Get the size of the grid as tiles across, tiles down and slices
+	/// </summary>
+	glm::vec3 getGrid();
+
+	/// <summary>
+	/// The slice of a view space depth d is floor(log(d) * getDepthScale() + getDepthBias())
+	/// </summary>
+	float getDepthScale();
+
+	/// <summary>
+	/// The slice of a view space depth d is floor(log(d) * getDepthScale() + getDepthBias())
+	/// </summary>
+	float getDepthBias();
+private:
+	// One task's share of the slices
+	struct SliceChunk {
+		// Cluster and light index for every overlap found
+		std::vector<std::pair<uint32_t, uint32_t>> hits;
+		std::vector<uint32_t> indices;
+	};
+
+	void binSlices(const std::vector<glm::vec4>& spheres, uint32_t firstIndex, int sliceBegin, int sliceEnd,
+		std::vector<uint32_t>& ranges, SliceChunk& chunk);
+	int sliceOf(float depth);
+
+	int _tilesX;
+	int _tilesY;
+	int _slices;
+	// Clusters per slice, rounded up to a multiple of 4 for SSE
+	int _sliceStride;
+	glm::mat4 _projection;
+	float _nearClip;
+	float _farClip;
+	float _depthScale;
+	float _depthBias;
+
+	// View space bounds of every cluster, split by component for SSE.
+	// Padding clusters have empty bounds so they never match.
+	std::vector<float> _minX;
+	std::vector<float> _minY;
+	std::vector<float> _minZ;
+	std::vector<float> _maxX;
+	std::vector<float> _maxY;
+	std::vector<float> _maxZ;
+
+	std::vector<SliceChunk> _chunks;
+};
\ No newline at end of file
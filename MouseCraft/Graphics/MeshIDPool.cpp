@@ -0,0 +1,28 @@
+#include "MeshIDPool.h"
+
+MeshIDPool& MeshIDPool::instance() {
+	// Never destroyed, geometries owned by other statics still release their IDs at exit
+	static MeshIDPool* pool = new MeshIDPool();
+	return *pool;
+}
+
+int MeshIDPool::acquire() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_free.empty()) return _next++;
+	int meshID = _free.back();
+	_free.pop_back();
+	return meshID;
+}
+
+void MeshIDPool::release(int meshID) {
+	if (meshID < 0) return;
+	std::lock_guard<std::mutex> lock(_mutex);
+	_released.push_back(meshID);
+}
+
+void MeshIDPool::collect(std::vector<int>& released) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	released.insert(released.end(), _released.begin(), _released.end());
+	_free.insert(_free.end(), _released.begin(), _released.end());
+	_released.clear();
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include <mutex>
+#include <vector>
+
+/// <summary>
+/// Hands out the IDs geometries are uploaded to the mesh arena under, and takes them back
+/// when a geometry changes or is destroyed, so IDs stay within the sort key's geometry field.
+/// Released IDs are only handed out again after the RenderSystem collects them
+/// and tells the backend to free their arena space.
+/// </summary>
+class MeshIDPool {
+public:
+	/// <summary>
+	/// Get the pool shared by every geometry
+	/// </summary>
+	static MeshIDPool& instance();
+
+	/// <summary>
+	/// Take an unused ID, preferring ones that were released and collected
+	/// </summary>
+	/// <returns>The new mesh ID</returns>
+	int acquire();
+
+	/// <summary>
+	/// Give back the ID of a geometry whose upload is no longer needed. Thread safe.
+	/// </summary>
+	/// <param name="meshID">An ID from acquire</param>
+	void release(int meshID);
+
+	/// <summary>
+	/// Make every ID released since the last call available to acquire again
+	/// </summary>
+	/// <param name="released">Has the collected IDs appended, so the backend can free their meshes</param>
+	void collect(std::vector<int>& released);
+private:
+	MeshIDPool() = default;
+
+	std::mutex _mutex;
+	int _next = 0;
+	std::vector<int> _free;
+	// Released but not collected, the backend may still hold their meshes
+	std::vector<int> _released;
+};
\ No newline at end of file
@@ -0,0 +1,268 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// The cache the triangle order is tuned for, and the one ACMR is reported against
+#define OPTIMIZE_CACHE_SIZE 32
+#define REPORT_CACHE_SIZE 16
+// Floats compared per vertex when welding: position, normal, texture coordinate
+#define WELD_FLOATS 8
+
+using std::vector;
+
+namespace {
+	// Forsyth's scoring: the last triangle's vertices get a flat score so strips don't win
+	// outright, older cache entries score less, and vertices with few triangles left score
+	// more so they get finished off rather than leaving lone triangles behind.
+	float vertexScore(int cachePosition, int remaining) {
+		if (remaining == 0) return -1.0f;
+		float score = 0.0f;
+		if (cachePosition >= 0) {
+			if (cachePosition < 3) {
+				score = 0.75f;
+			}
+			else {
+				score = powf(1.0f - (float)(cachePosition - 3) / (OPTIMIZE_CACHE_SIZE - 3), 1.5f);
+			}
+		}
+		return score + 2.0f / sqrtf((float)remaining);
+	}
+
+	uint32_t hashWords(const uint32_t* words, int count) {
+		uint32_t hash = 2166136261u;
+		for (int i = 0; i < count; i++) {
+			hash = (hash ^ words[i]) * 16777619u;
+		}
+		return hash;
+	}
+}
+
+void MeshOptimizer::optimize(Geometry* geometry, Stats* before, Stats* after) {
+	if (before != nullptr) *before = measure(geometry);
+	weld(geometry);
+	vector<GLuint> indices = geometry->getIndices();
+	optimizeVertexCache(indices, geometry->getVertexData().size() / 3);
+	geometry->setIndices(indices);
+	optimizeVertexFetch(geometry);
+	if (after != nullptr) *after = measure(geometry);
+}
+
+void MeshOptimizer::weld(Geometry* geometry) {
+	const vector<GLfloat>& positions = geometry->getVertexData();
+	const vector<GLfloat>& normals = geometry->getNormalData();
+	const vector<GLfloat>& texCoords = geometry->getTexCoordData();
+	size_t count = positions.size() / 3;
+	if (normals.size() != count * 3 || texCoords.size() != count * 2) return;
+
+	// Gather each vertex's attributes as raw words, with -0 turned into 0 so they compare equal
+	vector<uint32_t> keys(count * WELD_FLOATS);
+	for (size_t i = 0; i < count; i++) {
+		float values[WELD_FLOATS] = {
+			positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2],
+			normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2],
+			texCoords[i * 2], texCoords[i * 2 + 1]
+		};
+		for (int j = 0; j < WELD_FLOATS; j++) {
+			float value = values[j] == 0.0f ? 0.0f : values[j];
+			memcpy(&keys[i * WELD_FLOATS + j], &value, sizeof(float));
+		}
+	}
+
+	// Open addressing table of the first vertex seen with each key, at most half full
+	size_t capacity = 16;
+	while (capacity < count * 2) {
+		capacity *= 2;
+	}
+	const GLuint EMPTY = 0xFFFFFFFF;
+	vector<GLuint> table(capacity, EMPTY);
+	vector<GLuint> remap(count);
+	vector<GLfloat> newPositions, newNormals, newTexCoords;
+	newPositions.reserve(positions.size());
+	newNormals.reserve(normals.size());
+	newTexCoords.reserve(texCoords.size());
+	for (size_t i = 0; i < count; i++) {
+		const uint32_t* key = &keys[i * WELD_FLOATS];
+		size_t slot = hashWords(key, WELD_FLOATS) & (capacity - 1);
+		while (table[slot] != EMPTY && memcmp(&keys[table[slot] * WELD_FLOATS], key, WELD_FLOATS * sizeof(uint32_t)) != 0) {
+			slot = (slot + 1) & (capacity - 1);
+		}
+		if (table[slot] == EMPTY) {
+			table[slot] = i;
+			remap[i] = newPositions.size() / 3;
+			newPositions.insert(newPositions.end(), &positions[i * 3], &positions[i * 3] + 3);
+			newNormals.insert(newNormals.end(), &normals[i * 3], &normals[i * 3] + 3);
+			newTexCoords.insert(newTexCoords.end(), &texCoords[i * 2], &texCoords[i * 2] + 2);
+		}
+		else {
+			remap[i] = remap[table[slot]];
+		}
+	}
+	if (newPositions.size() == positions.size()) return;
+
+	vector<GLuint> indices = geometry->getIndices();
+	for (GLuint& index : indices) {
+		index = remap[index];
+	}
+	geometry->setVertexData(newPositions);
+	geometry->setNormalData(newNormals);
+	geometry->setTexCoordData(newTexCoords);
+	geometry->setIndices(indices);
+}
+
+void MeshOptimizer::optimizeVertexCache(vector<GLuint>& indices, size_t vertexCount) {
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) return;
+
+	// Triangles using each vertex, as ranges into one array. Used triangles are swapped
+	// to the end of their vertex's range, so the first remaining[v] entries are still to draw.
+	vector<uint32_t> remaining(vertexCount, 0);
+	for (GLuint index : indices) {
+		remaining[index]++;
+	}
+	vector<uint32_t> offsets(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++) {
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+	vector<uint32_t> adjacency(indices.size());
+	vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+	for (size_t t = 0; t < triangleCount; t++) {
+		for (int k = 0; k < 3; k++) {
+			adjacency[fill[indices[t * 3 + k]]++] = t;
+		}
+	}
+
+	vector<int> cachePosition(vertexCount, -1);
+	vector<float> scores(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++) {
+		scores[v] = vertexScore(-1, remaining[v]);
+	}
+	vector<float> triangleScores(triangleCount);
+	for (size_t t = 0; t < triangleCount; t++) {
+		triangleScores[t] = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+	}
+	vector<uint8_t> emitted(triangleCount, 0);
+
+	vector<GLuint> cache, nextCache;
+	cache.reserve(OPTIMIZE_CACHE_SIZE + 3);
+	nextCache.reserve(OPTIMIZE_CACHE_SIZE + 3);
+	vector<GLuint> output;
+	output.reserve(indices.size());
+
+	size_t best = std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin();
+	size_t scan = 0;
+	for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+		if (best == triangleCount) {
+			// Dead end, nothing in the cache has triangles left, so start again at the next unused one
+			while (emitted[scan]) scan++;
+			best = scan;
+		}
+
+		const GLuint* triangle = &indices[best * 3];
+		emitted[best] = 1;
+		output.insert(output.end(), triangle, triangle + 3);
+
+		// Take the triangle off each of its vertices' lists
+		for (int k = 0; k < 3; k++) {
+			GLuint v = triangle[k];
+			uint32_t* list = &adjacency[offsets[v]];
+			uint32_t* found = std::find(list, list + remaining[v], (uint32_t)best);
+			std::swap(*found, list[remaining[v] - 1]);
+			remaining[v]--;
+		}
+
+		// The triangle's vertices go to the front of the cache and push the rest back
+		nextCache.clear();
+		nextCache.insert(nextCache.end(), triangle, triangle + 3);
+		for (GLuint v : cache) {
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+				nextCache.push_back(v);
+			}
+		}
+		for (size_t i = 0; i < nextCache.size(); i++) {
+			cachePosition[nextCache[i]] = i < OPTIMIZE_CACHE_SIZE ? (int)i : -1;
+		}
+		if (nextCache.size() > OPTIMIZE_CACHE_SIZE) {
+			nextCache.resize(OPTIMIZE_CACHE_SIZE);
+		}
+		cache.swap(nextCache);
+
+		// Rescore everything touched and pick the best triangle that reuses the cache
+		for (GLuint v : nextCache) {
+			if (cachePosition[v] < 0) {
+				scores[v] = vertexScore(-1, remaining[v]);
+			}
+		}
+		for (GLuint v : cache) {
+			scores[v] = vertexScore(cachePosition[v], remaining[v]);
+		}
+		best = triangleCount;
+		float bestScore = -1.0f;
+		for (GLuint v : cache) {
+			for (uint32_t i = 0; i < remaining[v]; i++) {
+				uint32_t t = adjacency[offsets[v] + i];
+				float score = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+				triangleScores[t] = score;
+				if (score > bestScore) {
+					bestScore = score;
+					best = t;
+				}
+			}
+		}
+	}
+	indices.swap(output);
+}
+
+void MeshOptimizer::optimizeVertexFetch(Geometry* geometry) {
+	const vector<GLfloat>& positions = geometry->getVertexData();
+	const vector<GLfloat>& normals = geometry->getNormalData();
+	const vector<GLfloat>& texCoords = geometry->getTexCoordData();
+	size_t count = positions.size() / 3;
+	if (normals.size() != count * 3 || texCoords.size() != count * 2) return;
+
+	const GLuint UNUSED = 0xFFFFFFFF;
+	vector<GLuint> remap(count, UNUSED);
+	vector<GLuint> indices = geometry->getIndices();
+	vector<GLfloat> newPositions, newNormals, newTexCoords;
+	newPositions.reserve(positions.size());
+	newNormals.reserve(normals.size());
+	newTexCoords.reserve(texCoords.size());
+	for (GLuint& index : indices) {
+		if (remap[index] == UNUSED) {
+			remap[index] = newPositions.size() / 3;
+			newPositions.insert(newPositions.end(), &positions[index * 3], &positions[index * 3] + 3);
+			newNormals.insert(newNormals.end(), &normals[index * 3], &normals[index * 3] + 3);
+			newTexCoords.insert(newTexCoords.end(), &texCoords[index * 2], &texCoords[index * 2] + 2);
+		}
+		index = remap[index];
+	}
+	geometry->setVertexData(newPositions);
+	geometry->setNormalData(newNormals);
+	geometry->setTexCoordData(newTexCoords);
+	geometry->setIndices(indices);
+}
+
+float MeshOptimizer::computeACMR(const vector<GLuint>& indices, size_t vertexCount, size_t cacheSize) {
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) return 0.0f;
+
+	// A FIFO cache as a ring, with the time each vertex went in to test membership
+	vector<size_t> insertedAt(vertexCount, 0);
+	size_t misses = 0;
+	for (GLuint index : indices) {
+		if (insertedAt[index] == 0 || misses + 1 - insertedAt[index] > cacheSize) {
+			misses++;
+			insertedAt[index] = misses;
+		}
+	}
+	return (float)misses / triangleCount;
+}
+
+MeshOptimizer::Stats MeshOptimizer::measure(Geometry* geometry) {
+	Stats stats;
+	stats.vertices = geometry->getVertexData().size() / 3;
+	stats.triangles = geometry->getIndices().size() / 3;
+	stats.acmr = computeACMR(geometry->getIndices(), stats.vertices, REPORT_CACHE_SIZE);
+	return stats;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+#include "Geometry.h"
+#include <vector>
+
+// Import-time cleanup so meshes draw with as few vertex shader runs as possible.
+// Welds duplicate vertices, orders triangles for the post-transform vertex cache
+// (Forsyth's algorithm) and then orders vertices by first use for fetch locality.
+class MeshOptimizer {
+public:
+	struct Stats {
+		size_t vertices;
+		size_t triangles;
+		// Average cache miss ratio, vertex shader runs per triangle. 0.5 is ideal, 3 is no reuse
+		float acmr;
+	};
+
+	// Run every step in order. Stats may be null.
+	static void optimize(Geometry* geometry, Stats* before = nullptr, Stats* after = nullptr);
+	// Merge vertices whose position, normal and texture coordinate are bitwise equal
+	static void weld(Geometry* geometry);
+	// Reorder triangles so neighbours reuse vertices still in the cache
+	static void optimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount);
+	// Renumber vertices in the order the triangles first use them, dropping unused ones
+	static void optimizeVertexFetch(Geometry* geometry);
+	// Simulate a FIFO vertex cache to measure vertex shader runs per triangle
+	static float computeACMR(const std::vector<GLuint>& indices, size_t vertexCount, size_t cacheSize);
+	static Stats measure(Geometry* geometry);
+};
\ No newline at end of file
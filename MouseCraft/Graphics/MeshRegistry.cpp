@@ -0,0 +1,187 @@
+#include "MeshRegistry.h"
+#include "RenderUtil.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstddef>
+
+// The vertex arena is sized in floats, PackedVertex is a whole number of them
+#define VERTEX_FLOATS (sizeof(PackedVertex) / sizeof(GLfloat))
+
+using std::vector;
+
+MeshRegistry::MeshRegistry(size_t vertexCapacity, size_t indexCapacity) : _vertexCount(0), _indexWordCount(0) {
+	_vao = new VertexArrayObject();
+	_vertexVBO = new VertexBufferObject(VERTEX_FLOATS);
+	_ebo = new ElementBufferObject();
+	_instanceVBO = new VertexBufferObject(4);
+
+	_vertexVBO->reserve(vertexCapacity * VERTEX_FLOATS);
+	_ebo->reserve(indexCapacity);
+
+	attachBuffers();
+	attachInstances(0);
+}
+
+MeshRegistry::~MeshRegistry() {
+	delete _vao;
+	delete _vertexVBO;
+	delete _ebo;
+	delete _instanceVBO;
+}
+
+const MeshHandle& MeshRegistry::get(int meshID) {
+	if (meshID < 0 || meshID >= (int)_meshes.size()) {
+		static const MeshHandle empty = { 0, 0, 0, 0, GL_UNSIGNED_INT, 0 };
+		return empty;
+	}
+	return _meshes[meshID];
+}
+
+void MeshRegistry::bind() {
+	_vao->bind();
+}
+
+void MeshRegistry::draw(const MeshHandle& mesh) {
+	if (mesh.indexCount == 0) return;
+	glDrawElementsBaseVertex(
+		GL_TRIANGLES,
+		mesh.indexCount,
+		mesh.indexType,
+		(void*)(mesh.firstIndexWord * sizeof(GLuint)),
+		mesh.baseVertex
+	);
+}
+
+void MeshRegistry::bufferInstances(const vector<InstanceData>& instances) {
+	_instanceVBO->stream(instances.empty() ? nullptr : &instances[0], instances.size() * sizeof(InstanceData));
+}
+
+void MeshRegistry::drawInstanced(const MeshHandle& mesh, size_t firstInstance, size_t count) {
+	if (mesh.indexCount == 0 || count == 0) return;
+	// No base instance in GL 3.3, so move the instance attributes to the batch instead
+	attachInstances(firstInstance);
+	glDrawElementsInstancedBaseVertex(
+		GL_TRIANGLES,
+		mesh.indexCount,
+		mesh.indexType,
+		(void*)(mesh.firstIndexWord * sizeof(GLuint)),
+		count,
+		mesh.baseVertex
+	);
+}
+
+size_t MeshRegistry::getVertexCount() {
+	return _vertexCount;
+}
+
+size_t MeshRegistry::getIndexWordCount() {
+	return _indexWordCount;
+}
+
+size_t MeshRegistry::upload(const MeshUpload& data) {
+	const PackedMesh& packed = data.mesh;
+	// IDs are only reused after a release, but don't leak the space if one wasn't
+	release(data.meshID);
+
+	MeshHandle mesh = { 0, 0, 0, 0, packed.indexType, 0 };
+	if (!packed.vertices.empty() && packed.indexCount > 0) {
+		mesh.vertexCount = packed.vertices.size();
+		mesh.indexCount = packed.indexCount;
+		mesh.indexWordCount = packed.indexWords.size();
+		// Growing copies the arena up to the old ends, so only move them after
+		size_t vertexEnd = _vertexCount;
+		size_t indexWordEnd = _indexWordCount;
+		mesh.baseVertex = allocateRange(_freeVertices, vertexEnd, mesh.vertexCount);
+		mesh.firstIndexWord = allocateRange(_freeIndexWords, indexWordEnd, mesh.indexWordCount);
+		grow(vertexEnd, indexWordEnd);
+		_vertexCount = vertexEnd;
+		_indexWordCount = indexWordEnd;
+
+		_vertexVBO->bufferSubData(mesh.baseVertex * VERTEX_FLOATS, reinterpret_cast<const GLfloat*>(&packed.vertices[0]), mesh.vertexCount * VERTEX_FLOATS);
+		_ebo->bufferSubData(mesh.firstIndexWord, &packed.indexWords[0], mesh.indexWordCount);
+		RenderUtil::checkGLError("MeshRegistry::upload");
+	}
+
+	if (data.meshID >= (int)_meshes.size()) {
+		_meshes.resize(data.meshID + 1, MeshHandle{ 0, 0, 0, 0, GL_UNSIGNED_INT, 0 });
+	}
+	_meshes[data.meshID] = mesh;
+	return mesh.indexCount == 0 ? 0 : mesh.vertexCount * sizeof(PackedVertex) + mesh.indexWordCount * sizeof(GLuint);
+}
+
+void MeshRegistry::release(int meshID) {
+	if (meshID < 0 || meshID >= (int)_meshes.size()) return;
+	MeshHandle& mesh = _meshes[meshID];
+	freeRange(_freeVertices, _vertexCount, mesh.baseVertex, mesh.vertexCount);
+	freeRange(_freeIndexWords, _indexWordCount, mesh.firstIndexWord, mesh.indexWordCount);
+	mesh = MeshHandle{ 0, 0, 0, 0, GL_UNSIGNED_INT, 0 };
+}
+
+size_t MeshRegistry::allocateRange(vector<Range>& free, size_t& end, size_t size) {
+	for (size_t i = 0; i < free.size(); i++) {
+		if (free[i].size < size) continue;
+		size_t offset = free[i].offset;
+		free[i].offset += size;
+		free[i].size -= size;
+		if (free[i].size == 0) {
+			free.erase(free.begin() + i);
+		}
+		return offset;
+	}
+	size_t offset = end;
+	end += size;
+	return offset;
+}
+
+void MeshRegistry::freeRange(vector<Range>& free, size_t& end, size_t offset, size_t size) {
+	if (size == 0) return;
+	auto it = std::lower_bound(free.begin(), free.end(), offset, [](const Range& r, size_t o) { return r.offset < o; });
+	it = free.insert(it, Range{ offset, size });
+	if (it + 1 != free.end() && it->offset + it->size == (it + 1)->offset) {
+		it->size += (it + 1)->size;
+		free.erase(it + 1);
+	}
+	if (it != free.begin() && (it - 1)->offset + (it - 1)->size == it->offset) {
+		(it - 1)->size += it->size;
+		it = free.erase(it) - 1;
+	}
+	// Space at the end goes back to the arena rather than sitting in the list
+	if (it->offset + it->size == end) {
+		end = it->offset;
+		free.erase(it);
+	}
+}
+
+void MeshRegistry::grow(size_t vertices, size_t indexWords) {
+	bool reattach = false;
+	if (vertices * VERTEX_FLOATS > _vertexVBO->getCapacity()) {
+		size_t capacity = std::max(vertices, _vertexVBO->getCapacity() / VERTEX_FLOATS * 2);
+		_vertexVBO->reserve(capacity * VERTEX_FLOATS, _vertexCount * VERTEX_FLOATS);
+		reattach = true;
+	}
+	if (indexWords > _ebo->getCapacity()) {
+		size_t capacity = std::max(indexWords, _ebo->getCapacity() * 2);
+		_ebo->reserve(capacity, _indexWordCount);
+		reattach = true;
+	}
+	if (reattach) {
+		attachBuffers();
+	}
+}
+
+void MeshRegistry::attachBuffers() {
+	VertexFormat::setAttributes(*_vao, *_vertexVBO);
+	_vao->setElementBuffer(*_ebo);
+}
+
+void MeshRegistry::attachInstances(size_t firstInstance) {
+	// Locations 4-7 are the columns of the transform, 8 is the color, 9-11 the columns of the normal transform
+	size_t base = firstInstance * sizeof(InstanceData);
+	for (int i = 0; i < 4; i++) {
+		_vao->setAttribute(4 + i, *_instanceVBO, 4, sizeof(InstanceData), base + i * sizeof(glm::vec4), 1);
+	}
+	_vao->setAttribute(8, *_instanceVBO, 4, sizeof(InstanceData), base + offsetof(InstanceData, color), 1);
+	for (int i = 0; i < 3; i++) {
+		_vao->setAttribute(9 + i, *_instanceVBO, 3, sizeof(InstanceData), base + offsetof(InstanceData, normalTransform) + i * sizeof(glm::vec3), 1);
+	}
+}
\ No newline at end of file
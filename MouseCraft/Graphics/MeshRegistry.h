@@ -0,0 +1,124 @@
+#pragma once
+#include "../GL/glad.h"
+#include "RenderCommands.h"
+#include "BufferObjects/VertexArrayObject.h"
+#include "BufferObjects/VertexBufferObject.h"
+#include "BufferObjects/ElementBufferObject.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+/// <summary>
+/// The location of an uploaded geometry inside the mesh arena
+/// </summary>
+struct MeshHandle {
+	GLint baseVertex;
+	GLuint vertexCount;
+	// Offset into the index arena in 32 bit words, 16 bit indices are packed two per word
+	GLuint firstIndexWord;
+	GLuint indexCount;
+	GLenum indexType;
+	GLuint indexWordCount;
+};
+
+/// <summary>
+/// Keeps geometry resident on the GPU in one interleaved vertex buffer and one index buffer.
+/// Meshes are uploaded once under the ID the RenderSystem gave their geometry
+/// (or again under a new ID after it changes), after that draws only reference them by offset.
+/// Released meshes leave holes that later uploads fill first.
+/// </summary>
+class MeshRegistry {
+public:
+	/// <summary>
+	/// Creates the arena buffers and the VAO that reads from them
+	/// </summary>
+	/// <param name="vertexCapacity">Initial number of vertices the arena can hold</param>
+	/// <param name="indexCapacity">Initial number of 32 bit index words the arena can hold</param>
+	MeshRegistry(size_t vertexCapacity = 65536, size_t indexCapacity = 98304);
+	~MeshRegistry();
+
+	/// <summary>
+	/// Copy a mesh into the arena
+	/// </summary>
+	/// <param name="mesh">The mesh data and the ID to store it under</param>
+	/// <returns>The number of bytes copied to the GPU</returns>
+	size_t upload(const MeshUpload& mesh);
+
+	/// <summary>
+	/// Free a mesh's space in the arena so later uploads can reuse it
+	/// </summary>
+	/// <param name="meshID">The ID the mesh was uploaded with</param>
+	void release(int meshID);
+
+	/// <summary>
+	/// Get the arena location of an uploaded mesh
+	/// </summary>
+	/// <param name="meshID">The ID the mesh was uploaded with</param>
+	/// <returns>Where the mesh lives in the arena, empty if it was never uploaded</returns>
+	const MeshHandle& get(int meshID);
+
+	/// <summary>
+	/// Bind the VAO which reads from the arena
+	/// </summary>
+	void bind();
+
+	/// <summary>
+	/// Draw a resident mesh. The arena VAO must be bound.
+	/// </summary>
+	/// <param name="mesh">The mesh to draw</param>
+	void draw(const MeshHandle& mesh);
+
+	/// <summary>
+	/// Replace this frame's instance data. Read by drawInstanced.
+	/// </summary>
+	/// <param name="instances">Transforms and colors for every instance drawn this pass</param>
+	void bufferInstances(const std::vector<InstanceData>& instances);
+
+	/// <summary>
+	/// Draw count copies of a resident mesh in one call. The arena VAO must be bound.
+	/// </summary>
+	/// <param name="mesh">The mesh to draw</param>
+	/// <param name="firstInstance">The first instance in the buffered instance data</param>
+	/// <param name="count">The number of instances to draw</param>
+	void drawInstanced(const MeshHandle& mesh, size_t firstInstance, size_t count);
+
+	/// <summary>
+	/// Get the number of vertices the arena spans, including freed holes
+	/// </summary>
+	size_t getVertexCount();
+
+	/// <summary>
+	/// Get the number of 32 bit index words the arena spans, including freed holes
+	/// </summary>
+	size_t getIndexWordCount();
+private:
+	/// <summary>
+	/// A freed run of vertices or index words
+	/// </summary>
+	struct Range {
+		size_t offset;
+		size_t size;
+	};
+
+	// Take space from the first free range big enough, or from the end of the arena
+	static size_t allocateRange(std::vector<Range>& free, size_t& end, size_t size);
+	// Return space, merging it with its neighbours and shrinking the arena if it was at the end
+	static void freeRange(std::vector<Range>& free, size_t& end, size_t offset, size_t size);
+
+	void grow(size_t vertices, size_t indexWords);
+	void attachBuffers();
+	void attachInstances(size_t firstInstance);
+
+	VertexArrayObject* _vao;
+	VertexBufferObject* _vertexVBO;
+	ElementBufferObject* _ebo;
+	VertexBufferObject* _instanceVBO;
+
+	size_t _vertexCount;
+	size_t _indexWordCount;
+	// Sorted by offset
+	std::vector<Range> _freeVertices;
+	std::vector<Range> _freeIndexWords;
+
+	// Indexed by mesh ID
+	std::vector<MeshHandle> _meshes;
+};
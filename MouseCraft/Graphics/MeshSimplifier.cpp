@@ -0,0 +1,331 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+
+// Meshes with fewer triangles than this are drawn as they are at every distance
+#define MIN_LOD_TRIANGLES 128
+// A level must drop at least this fraction of its parent's triangles to be kept
+#define MIN_LOD_REDUCTION 0.25f
+// Boundary edges are held in place by planes this much heavier than the faces
+#define BOUNDARY_WEIGHT 10.0
+// Collapses turning a face more than this far (cosine) are refused
+#define MAX_FLIP_COSINE 0.2
+
+using std::vector;
+using glm::dvec3;
+using glm::vec3;
+
+namespace {
+	// Symmetric 4x4 matrix, the sum of squared distances to a set of planes
+	struct Quadric {
+		double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+
+		void clear() {
+			a2 = ab = ac = ad = b2 = bc = bd = c2 = cd = d2 = 0.0;
+		}
+
+		void addPlane(const dvec3& n, double d, double weight) {
+			a2 += weight * n.x * n.x; ab += weight * n.x * n.y; ac += weight * n.x * n.z; ad += weight * n.x * d;
+			b2 += weight * n.y * n.y; bc += weight * n.y * n.z; bd += weight * n.y * d;
+			c2 += weight * n.z * n.z; cd += weight * n.z * d;
+			d2 += weight * d * d;
+		}
+
+		void add(const Quadric& q) {
+			a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+			b2 += q.b2; bc += q.bc; bd += q.bd;
+			c2 += q.c2; cd += q.cd;
+			d2 += q.d2;
+		}
+
+		double error(const dvec3& p) const {
+			return a2 * p.x * p.x + 2.0 * ab * p.x * p.y + 2.0 * ac * p.x * p.z + 2.0 * ad * p.x
+				+ b2 * p.y * p.y + 2.0 * bc * p.y * p.z + 2.0 * bd * p.y
+				+ c2 * p.z * p.z + 2.0 * cd * p.z
+				+ d2;
+		}
+	};
+
+	struct Collapse {
+		double cost;
+		uint32_t from;
+		uint32_t to;
+		// The versions of both ends when queued, the collapse is stale once either changes
+		uint32_t fromVersion;
+		uint32_t toVersion;
+
+		bool operator>(const Collapse& other) const {
+			return cost > other.cost;
+		}
+	};
+
+	uint64_t edgeKey(uint32_t a, uint32_t b) {
+		return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+	}
+}
+
+Geometry* MeshSimplifier::simplify(Geometry* source, size_t targetTriangles) {
+	const vector<GLfloat>& positions = source->getVertexData();
+	const vector<GLfloat>& normals = source->getNormalData();
+	const vector<GLfloat>& texCoords = source->getTexCoordData();
+	const vector<GLfloat>& smoothNormals = source->getSmoothNormalData();
+	const vector<GLuint>& indices = source->getIndices();
+	size_t vertexCount = positions.size() / 3;
+	size_t triangleCount = indices.size() / 3;
+	if (normals.size() != vertexCount * 3 || texCoords.size() != vertexCount * 2 || triangleCount <= targetTriangles) {
+		return nullptr;
+	}
+
+	// Weld by exact position, so collapses see through normal and UV seams
+	vector<uint32_t> pointOf(vertexCount);
+	vector<dvec3> points;
+	{
+		std::unordered_map<uint64_t, vector<uint32_t>> buckets;
+		for (size_t i = 0; i < vertexCount; i++) {
+			vec3 p(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+			uint32_t bits[3];
+			memcpy(bits, &p, sizeof(bits));
+			uint64_t hash = ((uint64_t)bits[0] * 73856093u) ^ ((uint64_t)bits[1] * 19349663u) ^ ((uint64_t)bits[2] * 83492791u);
+			vector<uint32_t>& bucket = buckets[hash];
+			uint32_t found = (uint32_t)points.size();
+			for (uint32_t point : bucket) {
+				if (points[point] == dvec3(p)) {
+					found = point;
+					break;
+				}
+			}
+			if (found == points.size()) {
+				points.push_back(dvec3(p));
+				bucket.push_back(found);
+			}
+			pointOf[i] = found;
+		}
+	}
+	size_t pointCount = points.size();
+
+	// Every attribute vertex sitting on each point, to pick from when a corner moves
+	vector<vector<uint32_t>> verticesAt(pointCount);
+	for (size_t i = 0; i < vertexCount; i++) {
+		verticesAt[pointOf[i]].push_back(i);
+	}
+
+	// Triangles keep both the point and the attribute vertex of each corner
+	vector<uint32_t> corners(indices.begin(), indices.end());
+	vector<uint32_t> triPoints(indices.size());
+	for (size_t i = 0; i < indices.size(); i++) {
+		triPoints[i] = pointOf[indices[i]];
+	}
+	vector<uint8_t> triAlive(triangleCount, 1);
+	vector<vector<uint32_t>> trianglesAt(pointCount);
+	for (size_t t = 0; t < triangleCount; t++) {
+		for (int k = 0; k < 3; k++) {
+			vector<uint32_t>& list = trianglesAt[triPoints[t * 3 + k]];
+			if (list.empty() || list.back() != t) list.push_back(t);
+		}
+	}
+
+	// Face planes weighted by area, plus planes through boundary edges so outlines keep their shape
+	vector<Quadric> quadrics(pointCount);
+	for (Quadric& q : quadrics) {
+		q.clear();
+	}
+	std::unordered_map<uint64_t, int> edgeUses;
+	for (size_t t = 0; t < triangleCount; t++) {
+		const dvec3& p0 = points[triPoints[t * 3]];
+		const dvec3& p1 = points[triPoints[t * 3 + 1]];
+		const dvec3& p2 = points[triPoints[t * 3 + 2]];
+		dvec3 cross = glm::cross(p1 - p0, p2 - p0);
+		double length = glm::length(cross);
+		if (length > 0.0) {
+			dvec3 n = cross / length;
+			double d = -glm::dot(n, p0);
+			for (int k = 0; k < 3; k++) {
+				quadrics[triPoints[t * 3 + k]].addPlane(n, d, length * 0.5);
+			}
+		}
+		for (int k = 0; k < 3; k++) {
+			edgeUses[edgeKey(triPoints[t * 3 + k], triPoints[t * 3 + (k + 1) % 3])]++;
+		}
+	}
+	for (size_t t = 0; t < triangleCount; t++) {
+		const dvec3& p0 = points[triPoints[t * 3]];
+		const dvec3& p1 = points[triPoints[t * 3 + 1]];
+		const dvec3& p2 = points[triPoints[t * 3 + 2]];
+		dvec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+		if (glm::length(faceNormal) == 0.0) continue;
+		for (int k = 0; k < 3; k++) {
+			uint32_t a = triPoints[t * 3 + k];
+			uint32_t b = triPoints[t * 3 + (k + 1) % 3];
+			if (edgeUses[edgeKey(a, b)] != 1) continue;
+			dvec3 edge = points[b] - points[a];
+			dvec3 n = glm::cross(edge, faceNormal);
+			double length = glm::length(n);
+			if (length == 0.0) continue;
+			n /= length;
+			double d = -glm::dot(n, points[a]);
+			double weight = BOUNDARY_WEIGHT * glm::dot(edge, edge);
+			quadrics[a].addPlane(n, d, weight);
+			quadrics[b].addPlane(n, d, weight);
+		}
+	}
+
+	vector<uint32_t> versions(pointCount, 0);
+	vector<uint8_t> pointAlive(pointCount, 1);
+	std::priority_queue<Collapse, vector<Collapse>, std::greater<Collapse>> queue;
+	auto pushEdge = [&](uint32_t a, uint32_t b) {
+		Quadric q = quadrics[a];
+		q.add(quadrics[b]);
+		double toB = q.error(points[b]);
+		double toA = q.error(points[a]);
+		Collapse c;
+		c.cost = std::min(toA, toB);
+		c.from = toB <= toA ? a : b;
+		c.to = toB <= toA ? b : a;
+		c.fromVersion = versions[c.from];
+		c.toVersion = versions[c.to];
+		queue.push(c);
+	};
+	for (const auto& edge : edgeUses) {
+		pushEdge((uint32_t)(edge.first >> 32), (uint32_t)(edge.first & 0xFFFFFFFF));
+	}
+
+	size_t aliveTriangles = triangleCount;
+	vector<uint32_t> neighbours;
+	while (aliveTriangles > targetTriangles && !queue.empty()) {
+		Collapse c = queue.top();
+		queue.pop();
+		if (!pointAlive[c.from] || !pointAlive[c.to] ||
+			versions[c.from] != c.fromVersion || versions[c.to] != c.toVersion) continue;
+
+		// Refuse collapses that would fold a surviving triangle over
+		bool flips = false;
+		for (uint32_t t : trianglesAt[c.from]) {
+			if (!triAlive[t]) continue;
+			const uint32_t* tri = &triPoints[t * 3];
+			if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) continue;
+			dvec3 before = glm::cross(points[tri[1]] - points[tri[0]], points[tri[2]] - points[tri[0]]);
+			dvec3 moved[3];
+			for (int k = 0; k < 3; k++) {
+				moved[k] = tri[k] == c.from ? points[c.to] : points[tri[k]];
+			}
+			dvec3 after = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+			double lengths = glm::length(before) * glm::length(after);
+			if (lengths == 0.0 || glm::dot(before, after) < MAX_FLIP_COSINE * lengths) {
+				flips = true;
+				break;
+			}
+		}
+		if (flips) continue;
+
+		// Triangles on the edge disappear, the rest move their corner onto the kept point
+		for (uint32_t t : trianglesAt[c.from]) {
+			if (!triAlive[t]) continue;
+			uint32_t* tri = &triPoints[t * 3];
+			if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) {
+				triAlive[t] = 0;
+				aliveTriangles--;
+				continue;
+			}
+			for (int k = 0; k < 3; k++) {
+				if (tri[k] != c.from) continue;
+				tri[k] = c.to;
+				// Take the attribute vertex at the kept point whose normal best matches the old corner
+				uint32_t old = corners[t * 3 + k];
+				vec3 oldNormal(normals[old * 3], normals[old * 3 + 1], normals[old * 3 + 2]);
+				float bestDot = -2.0f;
+				for (uint32_t v : verticesAt[c.to]) {
+					float d = glm::dot(oldNormal, vec3(normals[v * 3], normals[v * 3 + 1], normals[v * 3 + 2]));
+					if (d > bestDot) {
+						bestDot = d;
+						corners[t * 3 + k] = v;
+					}
+				}
+			}
+			trianglesAt[c.to].push_back(t);
+		}
+		pointAlive[c.from] = 0;
+		trianglesAt[c.from].clear();
+		quadrics[c.to].add(quadrics[c.from]);
+		versions[c.to]++;
+
+		// Requeue every edge around the kept point with its new cost
+		vector<uint32_t>& around = trianglesAt[c.to];
+		around.erase(std::remove_if(around.begin(), around.end(), [&](uint32_t t) { return !triAlive[t]; }), around.end());
+		neighbours.clear();
+		for (uint32_t t : around) {
+			for (int k = 0; k < 3; k++) {
+				uint32_t p = triPoints[t * 3 + k];
+				if (p != c.to) neighbours.push_back(p);
+			}
+		}
+		std::sort(neighbours.begin(), neighbours.end());
+		neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+		for (uint32_t p : neighbours) {
+			versions[p]++;
+		}
+		for (uint32_t p : neighbours) {
+			pushEdge(c.to, p);
+		}
+	}
+	if (aliveTriangles >= triangleCount) return nullptr;
+
+	// Copy out the surviving triangles with the attribute vertices they reference
+	const uint32_t UNUSED = 0xFFFFFFFF;
+	vector<uint32_t> remap(vertexCount, UNUSED);
+	bool smooth = smoothNormals.size() == normals.size();
+	vector<GLfloat> newPositions, newNormals, newSmoothNormals, newTexCoords;
+	vector<GLuint> newIndices;
+	newIndices.reserve(aliveTriangles * 3);
+	for (size_t t = 0; t < triangleCount; t++) {
+		if (!triAlive[t]) continue;
+		for (int k = 0; k < 3; k++) {
+			uint32_t v = corners[t * 3 + k];
+			if (remap[v] == UNUSED) {
+				remap[v] = newPositions.size() / 3;
+				newPositions.insert(newPositions.end(), &positions[v * 3], &positions[v * 3] + 3);
+				newNormals.insert(newNormals.end(), &normals[v * 3], &normals[v * 3] + 3);
+				newTexCoords.insert(newTexCoords.end(), &texCoords[v * 2], &texCoords[v * 2] + 2);
+				if (smooth) newSmoothNormals.insert(newSmoothNormals.end(), &smoothNormals[v * 3], &smoothNormals[v * 3] + 3);
+			}
+			newIndices.push_back(remap[v]);
+		}
+	}
+
+	Geometry* result = new Geometry();
+	result->setVertexData(newPositions);
+	result->setNormalData(newNormals);
+	result->setTexCoordData(newTexCoords);
+	if (smooth) result->setSmoothNormalData(newSmoothNormals);
+	result->setIndices(newIndices);
+	return result;
+}
+
+void MeshSimplifier::generateLODs(Geometry* geometry, int maxLevels) {
+	Geometry* previous = geometry;
+	for (int level = 0; level < maxLevels; level++) {
+		size_t triangles = previous->getIndices().size() / 3;
+		if (triangles < MIN_LOD_TRIANGLES * 2) break;
+
+		// Always simplify the full mesh so errors don't stack up level on level
+		Geometry* lod = simplify(geometry, triangles / 2);
+		if (lod == nullptr) break;
+		size_t lodTriangles = lod->getIndices().size() / 3;
+		if (lodTriangles > triangles * (1.0f - MIN_LOD_REDUCTION)) {
+			delete lod;
+			break;
+		}
+
+		vector<GLuint> indices = lod->getIndices();
+		MeshOptimizer::optimizeVertexCache(indices, lod->getVertexData().size() / 3);
+		lod->setIndices(indices);
+		MeshOptimizer::optimizeVertexFetch(lod);
+		lod->pack();
+		geometry->addLOD(lod);
+		previous = lod;
+	}
+}
\ No newline at end of file
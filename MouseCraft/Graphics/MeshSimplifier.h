@@ -0,0 +1,16 @@
+#pragma once
+#include "Geometry.h"
+
+// Builds lower detail versions of a mesh with quadric error metrics (Garland and Heckbert).
+// Edges are collapsed onto one of their ends, cheapest first, so every vertex that
+// survives is an original one and keeps its normal and texture coordinate.
+// Collapses work on positions, so seams in the normals or UVs don't block simplification.
+class MeshSimplifier {
+public:
+	// Collapse edges until at most targetTriangles are left or no valid collapse remains.
+	// Returns a new geometry, or null if it couldn't get below the source's triangle count.
+	static Geometry* simplify(Geometry* source, size_t targetTriangles);
+	// Attach up to maxLevels levels to the geometry, each with about half the triangles
+	// of the one before, stopping once meshes get too small to be worth it.
+	static void generateLODs(Geometry* geometry, int maxLevels = 3);
+};
\ No newline at end of file
@@ -1,99 +1,76 @@
 #include "ModelGen.h"
+#include <xmmintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <vector>
 
+// Positions closer than this are welded when averaging smooth normals
+#define WELD_PRECISION 100.0f
+
 using std::vector;
 
 Model* ModelGen::makeQuad(ModelGen::Axis facing, float width, float height) {
-	float halfwidth = width / 2.0f;
-	float halfheight = height / 2.0f;
-
 	vector<GLuint> indices = {
 		0, 1, 3,
 		0, 3, 2
 	};
+	vector<GLfloat> vertices = quadVertices(facing, width, height);
+	vector<GLfloat> normals;
+	for (int i = 0; i < 4; i++) {
+		normals.push_back(facing == ModelGen::Axis::X ? 1.0f : 0.0f);
+		normals.push_back(facing == ModelGen::Axis::Y ? 1.0f : 0.0f);
+		normals.push_back(facing == ModelGen::Axis::Z ? 1.0f : 0.0f);
+	}
+	vector<GLfloat> texCoord = {
+		0, 0,
+		1, 0,
+		0, 1,
+		1, 1
+	};
 
 	Geometry* g = new Geometry();
 	g->setIndices(indices);
+	g->setVertexData(vertices);
+	g->setNormalData(normals);
+	g->setTexCoordData(texCoord);
+
+	return new Model(g);
+}
+
+void ModelGen::resizeQuad(Model* quad, ModelGen::Axis facing, float width, float height) {
+	vector<GLfloat> vertices = quadVertices(facing, width, height);
+	quad->getGeometry()->setVertexData(vertices);
+}
+
+vector<GLfloat> ModelGen::quadVertices(ModelGen::Axis facing, float width, float height) {
+	float halfwidth = width / 2.0f;
+	float halfheight = height / 2.0f;
 
 	switch (facing) {
 	case ModelGen::Axis::X:
-	{
-		vector<GLfloat> vertices = {
+		return {
 			0, -halfheight, -halfwidth,
 			0, halfheight, -halfwidth,
 			0, -halfheight, halfwidth,
 			0, halfheight, halfwidth
 		};
-		vector<GLfloat> normals = {
-			1, 0, 0,
-			1, 0, 0,
-			1, 0, 0,
-			1, 0, 0
-		};
-		vector<GLfloat> texCoord = {
-			0, 0,
-			1, 0,
-			0, 1,
-			1, 1
-		};
-		g->setVertexData(vertices);
-		g->setNormalData(normals);
-		g->setTexCoordData(texCoord);
-		break;
-	}
 	case ModelGen::Axis::Y:
-	{
-		vector<GLfloat> vertices = {
+		return {
 			-halfwidth, 0, -halfheight,
 			-halfwidth, 0, halfheight,
 			halfwidth, 0, -halfheight,
 			halfwidth, 0, halfheight
 		};
-		vector<GLfloat> normals = {
-			0, 1, 0,
-			0, 1, 0,
-			0, 1, 0,
-			0, 1, 0
-		};
-		vector<GLfloat> texCoord = {
-			0, 0,
-			1, 0,
-			0, 1,
-			1, 1
-		};
-		g->setVertexData(vertices);
-		g->setNormalData(normals);
-		g->setTexCoordData(texCoord);
-		break;
-	}
 	case ModelGen::Axis::Z:
-	{
-		vector<GLfloat> vertices = {
+	default:
+		return {
 			-halfwidth, -halfheight, 0,
 			halfwidth, -halfheight, 0,
 			-halfwidth, halfheight, 0,
 			halfwidth, halfheight, 0
 		};
-		vector<GLfloat> normals = {
-			0, 0, 1,
-			0, 0, 1,
-			0, 0, 1,
-			0, 0, 1
-		};
-		vector<GLfloat> texCoord = {
-			0, 0,
-			1, 0,
-			0, 1,
-			1, 1
-		};
-		g->setVertexData(vertices);
-		g->setNormalData(normals);
-		g->setTexCoordData(texCoord);
-		break;
-	}
 	}
-
-	return new Model(g);
 }
 
 Model* ModelGen::makeCube(float width, float height, float depth) {
@@ -199,6 +176,73 @@ Model* ModelGen::makeCube(float width, float height, float depth) {
 	g->setNormalData(normals);
 	g->setTexCoordData(texCoord);
 	g->setIndices(indices);
+	generateSmoothNormals(g);
+	g->pack();
 
 	return new Model(g);
+}
+
+void ModelGen::generateSmoothNormals(Geometry* geometry) {
+	vector<GLfloat>& vertices = geometry->getVertexData();
+	vector<GLfloat>& normals = geometry->getNormalData();
+	size_t count = std::min(vertices.size(), normals.size()) / 3;
+
+	// Open addressing table keyed on the quantized position, at most half full
+	// Sums are kept unaligned since vector doesn't promise 16 byte alignment
+	struct Cell {
+		int32_t key[3];
+		bool used;
+		float sum[4];
+	};
+	size_t capacity = 16;
+	while (capacity < count * 2) {
+		capacity *= 2;
+	}
+	vector<Cell> cells(capacity);
+	for (Cell& cell : cells) {
+		cell.used = false;
+		_mm_storeu_ps(cell.sum, _mm_setzero_ps());
+	}
+	vector<uint32_t> cellOf(count);
+
+	for (size_t i = 0; i < count; i++) {
+		int32_t key[3] = {
+			(int32_t)roundf(vertices[i * 3] * WELD_PRECISION),
+			(int32_t)roundf(vertices[i * 3 + 1] * WELD_PRECISION),
+			(int32_t)roundf(vertices[i * 3 + 2] * WELD_PRECISION)
+		};
+		uint32_t hash = (uint32_t)key[0] * 73856093u ^ (uint32_t)key[1] * 19349663u ^ (uint32_t)key[2] * 83492791u;
+		size_t slot = hash & (capacity - 1);
+		while (cells[slot].used &&
+			(cells[slot].key[0] != key[0] || cells[slot].key[1] != key[1] || cells[slot].key[2] != key[2])) {
+			slot = (slot + 1) & (capacity - 1);
+		}
+		Cell& cell = cells[slot];
+		if (!cell.used) {
+			cell.used = true;
+			cell.key[0] = key[0];
+			cell.key[1] = key[1];
+			cell.key[2] = key[2];
+		}
+		__m128 normal = _mm_set_ps(0.0f, normals[i * 3 + 2], normals[i * 3 + 1], normals[i * 3]);
+		_mm_storeu_ps(cell.sum, _mm_add_ps(_mm_loadu_ps(cell.sum), normal));
+		cellOf[i] = slot;
+	}
+
+	// Normalize each welded sum once, then hand it back to every vertex in the cell
+	for (Cell& cell : cells) {
+		if (!cell.used) continue;
+		float total = cell.sum[0] * cell.sum[0] + cell.sum[1] * cell.sum[1] + cell.sum[2] * cell.sum[2];
+		if (total > 0.0f) {
+			_mm_storeu_ps(cell.sum, _mm_mul_ps(_mm_loadu_ps(cell.sum), _mm_set1_ps(1.0f / sqrtf(total))));
+		}
+	}
+	vector<GLfloat> smoothNormals(count * 3);
+	for (size_t i = 0; i < count; i++) {
+		const float* normal = cells[cellOf[i]].sum;
+		smoothNormals[i * 3] = normal[0];
+		smoothNormals[i * 3 + 1] = normal[1];
+		smoothNormals[i * 3 + 2] = normal[2];
+	}
+	geometry->setSmoothNormalData(smoothNormals);
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "Model.h"
+#include <vector>
 class ModelGen {
 public:
 	enum Axis {
@@ -9,4 +10,11 @@ public:
 	};
 	static Model* makeQuad(ModelGen::Axis facing, float width, float height);
 	static Model* makeCube(float width, float height, float depth);
+	// Resize a quad made by makeQuad in place
+	static void resizeQuad(Model* quad, ModelGen::Axis facing, float width, float height);
+	// Average the normals of vertices that share a position, for outlines.
+	// Run once when the geometry is made so drawing outlines costs nothing extra.
+	static void generateSmoothNormals(Geometry* geometry);
+private:
+	static std::vector<GLfloat> quadVertices(ModelGen::Axis facing, float width, float height);
 };
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "NullRenderBackend.h"
+#include "../Core/EngineMetrics.h"
+
+NullRenderBackend::NullRenderBackend() {
+	profiler.InitializeTimers(1);
+	profiler.InitializeCounters(4);
+	profiler.LogOutput("NullRendering.log");	// optional
+}
+
+void NullRenderBackend::execute(const RenderCommandBuffer& buffer) {
+	profiler.StartTimer(0);
+	for (const RenderCommandBuffer::Command& command : buffer.commands) {
+		profiler.AddToCounter(COMMANDS);
+		switch (command.type) {
+		case RenderCommandBuffer::UPLOAD_MESHES:
+		case RenderCommandBuffer::UPLOAD_TEXTURES:
+			profiler.AddToCounter(UPLOADS, command.count);
+			break;
+		case RenderCommandBuffer::DRAW_SCENE:
+		case RenderCommandBuffer::DRAW_OUTLINES:
+			// One instanced draw per batch, as the GL backend would issue
+			profiler.AddToCounter(DRAW_CALLS, command.count);
+			for (uint32_t i = command.first; i < command.first + command.count; i++) {
+				profiler.AddToCounter(INSTANCES, buffer.batches[i].instanceCount);
+			}
+			break;
+		case RenderCommandBuffer::DRAW_LIGHTING:
+			profiler.AddToCounter(DRAW_CALLS);
+			break;
+		case RenderCommandBuffer::DRAW_UI:
+			profiler.AddToCounter(DRAW_CALLS, command.count > 0 ? 1 : 0);
+			break;
+		default:
+			break;
+		}
+	}
+	profiler.StopTimer(0);
+
+	// Published under the GL backend's names so headless runs can be compared with it
+	EngineMetrics& metrics = EngineMetrics::Instance();
+	metrics.Set("render.frame.cpu_ms", profiler.GetDurationSec(0) * 1000.0);
+	metrics.Set("render.draw_calls", (double)profiler.GetCounter(DRAW_CALLS));
+	metrics.Set("render.instances", (double)profiler.GetCounter(INSTANCES));
+	profiler.FrameFinish();
+}
+
+void NullRenderBackend::present() {
+}
\ No newline at end of file
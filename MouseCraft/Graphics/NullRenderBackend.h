@@ -0,0 +1,26 @@
+#pragma once
+#include "RenderBackend.h"
+#include "../Util/CpuProfiler.h"
+
+/// <summary>
+/// Walks recorded frames without drawing anything, for running the game without a window.
+/// Logs what a real backend would have been asked to do, so headless runs can
+/// measure simulation and recording cost on their own.
+/// </summary>
+class NullRenderBackend : public RenderBackend {
+public:
+	NullRenderBackend();
+
+	void execute(const RenderCommandBuffer& buffer) override;
+	void present() override;
+private:
+	// Profiler counters
+	enum NullCounter {
+		COMMANDS = 0,
+		DRAW_CALLS = 1,
+		INSTANCES = 2,
+		UPLOADS = 3
+	};
+
+	CpuProfiler profiler;
+};
\ No newline at end of file
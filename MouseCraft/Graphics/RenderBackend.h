@@ -0,0 +1,22 @@
+#pragma once
+#include "RenderCommands.h"
+
+/// <summary>
+/// Replays recorded frames with a graphics API.
+/// A backend owns every API resource it creates and is only used from the thread that made it.
+/// </summary>
+class RenderBackend {
+public:
+	virtual ~RenderBackend() {}
+
+	/// <summary>
+	/// Replay every command of a recorded frame in order
+	/// </summary>
+	/// <param name="buffer">The frame, left untouched so it can be reused</param>
+	virtual void execute(const RenderCommandBuffer& buffer) = 0;
+
+	/// <summary>
+	/// Show the frame that was just executed
+	/// </summary>
+	virtual void present() = 0;
+};
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "RenderCommands.h"
+#include "MeshIDPool.h"
+
+using std::vector;
+using glm::vec2;
+using glm::vec4;
+using glm::mat4;
+
+RenderCommandBuffer::RenderCommandBuffer() {
+	clear();
+}
+
+void RenderCommandBuffer::clear() {
+	commands.clear();
+	meshReleases.clear();
+	_meshUploadCount = 0;
+	textureUploads.clear();
+	textureLayers = 0;
+	instances.clear();
+	batches.clear();
+	_firstBatch = 0;
+	lights.clear();
+	clusterRanges.clear();
+	lightIndices.clear();
+	uiVertices.clear();
+	uiIndices.clear();
+}
+
+void RenderCommandBuffer::uploadMesh(int meshID, Geometry* geometry) {
+	// Keep the old upload's vectors so copying into them doesn't allocate
+	if (_meshUploadCount == meshUploads.size()) {
+		meshUploads.emplace_back();
+	}
+	MeshUpload& upload = meshUploads[_meshUploadCount];
+	upload.meshID = meshID;
+	upload.mesh = geometry->getPackedMesh();
+	push(UPLOAD_MESHES, _meshUploadCount++, 1);
+}
+
+void RenderCommandBuffer::releaseMeshes() {
+	size_t first = meshReleases.size();
+	MeshIDPool::instance().collect(meshReleases);
+	if (meshReleases.size() > first) {
+		push(RELEASE_MESHES, first, meshReleases.size() - first);
+	}
+}
+
+void RenderCommandBuffer::uploadTexture(int layer, int x, int y, vector<MipLevel>& levels) {
+	TextureUpload upload;
+	upload.layer = layer;
+	upload.x = x;
+	upload.y = y;
+	upload.levels.swap(levels);
+	textureUploads.push_back(std::move(upload));
+	push(UPLOAD_TEXTURES, textureUploads.size() - 1, 1);
+}
+
+void RenderCommandBuffer::beginFrame(const mat4& view, const mat4& projection) {
+	camera.view = view;
+	camera.projection = projection;
+	camera.viewProjection = projection * view;
+	push(BEGIN_FRAME, 0, 0);
+}
+
+void RenderCommandBuffer::beginBatches() {
+	_firstBatch = batches.size();
+}
+
+void RenderCommandBuffer::addInstance(bool newBatch, int meshID, const TextureRegion& texture, const mat4& transform, const vec4& color) {
+	if (newBatch || batches.size() == _firstBatch) {
+		DrawBatch batch;
+		batch.meshID = meshID;
+		batch.texture = texture;
+		batch.firstInstance = instances.size();
+		batch.instanceCount = 0;
+		batches.push_back(batch);
+	}
+	InstanceData instance;
+	instance.transform = transform;
+	instance.color = color;
+	instance.normalTransform = glm::transpose(glm::inverse(glm::mat3(transform)));
+	instances.push_back(instance);
+	batches.back().instanceCount++;
+}
+
+void RenderCommandBuffer::drawBatches(CommandType pass) {
+	push(pass, _firstBatch, batches.size() - _firstBatch);
+}
+
+void RenderCommandBuffer::drawLighting(const LightingParams& params) {
+	lighting = params;
+	push(DRAW_LIGHTING, 0, lights.size());
+}
+
+void RenderCommandBuffer::addUI(Geometry* geometry, const mat4& transform, const vec4& color, const TextureRegion& texture) {
+	vector<GLfloat>& positions = geometry->getVertexData();
+	vector<GLfloat>& texCoords = geometry->getTexCoordData();
+	vector<GLuint>& indices = geometry->getIndices();
+	GLuint base = uiVertices.size();
+	size_t count = positions.size() / 3;
+
+	for (size_t i = 0; i < count; i++) {
+		UIVertex v;
+		v.position = transform * vec4(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2], 1.0f);
+		v.color = color;
+		v.texCoord = i * 2 + 1 < texCoords.size() ? vec2(texCoords[i * 2], texCoords[i * 2 + 1]) : vec2(0.0f);
+		v.textureRect = texture.rect;
+		v.layer = texture.layer;
+		v.maxLod = texture.maxLod;
+		uiVertices.push_back(v);
+	}
+	for (GLuint index : indices) {
+		uiIndices.push_back(base + index);
+	}
+}
+
+void RenderCommandBuffer::drawUI() {
+	push(DRAW_UI, 0, uiIndices.size());
+}
+
+void RenderCommandBuffer::push(CommandType type, uint32_t first, uint32_t count) {
+	Command command;
+	command.type = type;
+	command.first = first;
+	command.count = count;
+	commands.push_back(command);
+}
\ No newline at end of file
@@ -0,0 +1,222 @@
+#pragma once
+#include "../GL/glad.h"
+#include "Geometry.h"
+#include "TextureAtlas.h"
+#include "TextureFilter.h"
+#include "Light.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Per-instance data streamed next to the arena for instanced draws
+/// </summary>
+struct InstanceData {
+	glm::mat4 transform;
+	glm::vec4 color;
+	// Inverse transpose of the transform, so shaders don't invert it per vertex
+	glm::mat3 normalTransform;
+};
+
+/// <summary>
+/// A UI vertex already in clip space, carrying its own tint and atlas region
+/// </summary>
+struct UIVertex {
+	glm::vec4 position;
+	glm::vec4 color;
+	glm::vec4 textureRect;
+	glm::vec2 texCoord;
+	float layer;
+	float maxLod;
+};
+
+/// <summary>
+/// A light as the lighting shader reads it, five vec4s per light
+/// </summary>
+struct LightData {
+	Light::LightType type;
+	int blank1;
+	int blank2;
+	int blank3;
+	glm::vec4 color;
+	glm::vec4 position;
+	glm::vec4 direction;
+	glm::vec4 attenuation; // Constant, Linear, Quadratic, unused
+};
+
+/// <summary>
+/// Camera matrices shared by the scene shaders (std140, all mat4s)
+/// </summary>
+struct CameraData {
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::mat4 viewProjection;
+};
+
+/// <summary>
+/// A copy of a packed geometry to put in the mesh arena under the given ID
+/// </summary>
+struct MeshUpload {
+	int meshID;
+	PackedMesh mesh;
+};
+
+/// <summary>
+/// A mip chain to copy into a cell of the texture atlas
+/// </summary>
+struct TextureUpload {
+	int layer;
+	int x;
+	int y;
+	std::vector<MipLevel> levels;
+};
+
+/// <summary>
+/// A run of instances sharing a mesh and texture, drawn with one call
+/// </summary>
+struct DrawBatch {
+	int meshID;
+	TextureRegion texture;
+	uint32_t firstInstance;
+	uint32_t instanceCount;
+};
+
+/// <summary>
+/// What the lighting pass needs besides the light arrays
+/// </summary>
+struct LightingParams {
+	int quadMeshID;
+	uint32_t globalLights;
+	glm::vec3 ambientColor;
+	glm::vec3 clusterGrid;
+	float clusterDepthScale;
+	float clusterDepthBias;
+};
+
+/// <summary>
+/// One frame of rendering recorded as plain data, with no graphics API calls.
+/// The RenderSystem records it on the simulation thread and a RenderBackend replays it,
+/// possibly on another thread. Everything a command needs is copied in,
+/// so the scene can change or delete objects while the frame is replayed.
+/// </summary>
+class RenderCommandBuffer {
+public:
+	enum CommandType {
+		// Free the arena space of meshReleases[first, first + count), their IDs may be uploaded again after
+		RELEASE_MESHES,
+		// Put meshUploads[first, first + count) in the arena
+		UPLOAD_MESHES,
+		// Copy textureUploads[first, first + count) into the atlas
+		UPLOAD_TEXTURES,
+		// Clear the frame's targets and set the camera
+		BEGIN_FRAME,
+		// Fill the gbuffer with batches[first, first + count)
+		DRAW_SCENE,
+		// Draw batches[first, first + count) as outlines
+		DRAW_OUTLINES,
+		// Shade the gbuffer with the frame's lights
+		DRAW_LIGHTING,
+		// Draw the UI vertices in order
+		DRAW_UI
+	};
+
+	struct Command {
+		CommandType type;
+		uint32_t first;
+		uint32_t count;
+	};
+
+	RenderCommandBuffer();
+
+	/// <summary>
+	/// Empty the buffer for recording, keeping its allocations
+	/// </summary>
+	void clear();
+
+	/// <summary>
+	/// Copy a geometry so the backend can put it in the mesh arena
+	/// </summary>
+	/// <param name="meshID">The ID the geometry was given</param>
+	/// <param name="geometry">The geometry to copy</param>
+	void uploadMesh(int meshID, Geometry* geometry);
+
+	/// <summary>
+	/// Collect the mesh IDs released since the last frame so the backend frees their meshes.
+	/// Call before any uploads, which may reuse the IDs.
+	/// </summary>
+	void releaseMeshes();
+
+	/// <summary>
+	/// Hand a mip chain to the backend to copy into the atlas
+	/// </summary>
+	/// <param name="layer">The atlas layer</param>
+	/// <param name="x">The left of the cell in texels</param>
+	/// <param name="y">The bottom of the cell in texels</param>
+	/// <param name="levels">The levels, moved out of the caller</param>
+	void uploadTexture(int layer, int x, int y, std::vector<MipLevel>& levels);
+
+	/// <summary>
+	/// Start drawing the frame from a camera
+	/// </summary>
+	void beginFrame(const glm::mat4& view, const glm::mat4& projection);
+
+	/// <summary>
+	/// Start a run of batches for a scene or outline pass. Add them with addInstance.
+	/// </summary>
+	void beginBatches();
+
+	/// <summary>
+	/// Add an instance, starting a new batch unless it continues the last one
+	/// </summary>
+	void addInstance(bool newBatch, int meshID, const TextureRegion& texture, const glm::mat4& transform, const glm::vec4& color);
+
+	/// <summary>
+	/// Draw every batch added since beginBatches
+	/// </summary>
+	/// <param name="pass">DRAW_SCENE or DRAW_OUTLINES</param>
+	void drawBatches(CommandType pass);
+
+	/// <summary>
+	/// Shade the gbuffer with the lights copied into lights, clusterRanges and lightIndices
+	/// </summary>
+	void drawLighting(const LightingParams& params);
+
+	/// <summary>
+	/// Append a geometry to the UI stream
+	/// </summary>
+	/// <param name="geometry">The geometry to copy</param>
+	/// <param name="transform">The matrix taking the geometry to clip space</param>
+	/// <param name="color">The tint applied to every vertex</param>
+	/// <param name="texture">The part of the texture atlas to sample</param>
+	void addUI(Geometry* geometry, const glm::mat4& transform, const glm::vec4& color, const TextureRegion& texture);
+
+	/// <summary>
+	/// Draw the UI stream
+	/// </summary>
+	void drawUI();
+
+	std::vector<Command> commands;
+	std::vector<int> meshReleases;
+	std::vector<MeshUpload> meshUploads;
+	std::vector<TextureUpload> textureUploads;
+	// The number of atlas layers in use once the uploads are done
+	int textureLayers;
+
+	CameraData camera;
+	std::vector<InstanceData> instances;
+	std::vector<DrawBatch> batches;
+
+	LightingParams lighting;
+	std::vector<LightData> lights;
+	std::vector<uint32_t> clusterRanges;
+	std::vector<uint32_t> lightIndices;
+
+	std::vector<UIVertex> uiVertices;
+	std::vector<GLuint> uiIndices;
+private:
+	void push(CommandType type, uint32_t first, uint32_t count);
+
+	uint32_t _firstBatch;
+	// Upload vectors are reused, so count the ones in use rather than clearing them
+	size_t _meshUploadCount;
+};
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "RenderGraph.h"
+#include "RenderUtil.h"
+#include <algorithm>
+
+// Pooled textures nothing used for this many frames are deleted
+#define RELEASE_FRAMES 120
+
+using std::string;
+using std::vector;
+
+const int RenderGraph::BACKBUFFER;
+
+RenderGraph::RenderGraph() {
+	Target backbuffer;
+	backbuffer.name = "backbuffer";
+	backbuffer.texture = -1;
+	_targets.push_back(backbuffer);
+}
+
+RenderGraph::~RenderGraph() {
+	for (Pass& pass : _passes) {
+		delete pass.fbo;
+	}
+	for (PooledTexture& pooled : _textures) {
+		delete pooled.texture;
+	}
+}
+
+int RenderGraph::addTarget(const string& name, GLenum format, float scale) {
+	Target target;
+	target.name = name;
+	target.texture = -1;
+	_targets.push_back(target);
+	return _schedule.addTarget(format, scale);
+}
+
+int RenderGraph::addPass(const string& name, const vector<int>& reads, const vector<int>& writes, std::function<void()> execute) {
+	Pass pass;
+	pass.name = name;
+	pass.execute = execute;
+	pass.fbo = nullptr;
+	_passes.push_back(pass);
+	return _schedule.addPass(reads, writes);
+}
+
+void RenderGraph::setPassEnabled(int pass, bool enabled) {
+	_schedule.setPassEnabled(pass, enabled);
+}
+
+void RenderGraph::setBackbufferSize(int width, int height) {
+	_schedule.setBackbufferSize(width, height);
+}
+
+void RenderGraph::setRenderScale(float scale) {
+	_schedule.setRenderScale(scale);
+}
+
+bool RenderGraph::isPassActive(int pass) {
+	return _schedule.isPassActive(pass);
+}
+
+GLTexture* RenderGraph::getTexture(int target) {
+	int texture = _targets[target].texture;
+	return texture >= 0 ? _textures[texture].texture : nullptr;
+}
+
+void RenderGraph::getTargetSize(int target, int& width, int& height) {
+	_schedule.getTargetSize(target, width, height);
+}
+
+size_t RenderGraph::getTargetMemory() {
+	size_t bytes = 0;
+	for (const PooledTexture& pooled : _textures) {
+		bytes += (size_t)pooled.width * pooled.height * bytesPerPixel(pooled.format);
+	}
+	return bytes;
+}
+
+void RenderGraph::compile() {
+	_schedule.compile();
+	assignTextures();
+	releaseUnused();
+}
+
+void RenderGraph::assignTextures() {
+	for (PooledTexture& pooled : _textures) {
+		pooled.used = false;
+	}
+
+	// Back every slot with a pooled texture of its format and size, creating any that are missing.
+	// Slots come in the same order every frame, so each keeps the texture it had last frame.
+	const vector<RenderGraphSchedule::Slot>& slots = _schedule.getSlots();
+	vector<int> slotTextures(slots.size(), -1);
+	for (size_t s = 0; s < slots.size(); s++) {
+		const RenderGraphSchedule::Slot& slot = slots[s];
+		int found = -1;
+		for (int i = 0; i < (int)_textures.size(); i++) {
+			PooledTexture& pooled = _textures[i];
+			if (!pooled.used && pooled.format == slot.format && pooled.width == slot.width && pooled.height == slot.height) {
+				found = i;
+				break;
+			}
+		}
+		if (found < 0) {
+			PooledTexture pooled;
+			pooled.texture = new GLTexture();
+			pooled.texture->allocate(slot.width, slot.height, slot.format);
+			pooled.format = slot.format;
+			pooled.width = slot.width;
+			pooled.height = slot.height;
+			found = _textures.size();
+			_textures.push_back(pooled);
+		}
+		_textures[found].used = true;
+		_textures[found].unusedFrames = 0;
+		slotTextures[s] = found;
+	}
+
+	for (size_t t = 1; t < _targets.size(); t++) {
+		int slot = _schedule.getSlot(t);
+		_targets[t].texture = slot >= 0 ? slotTextures[slot] : -1;
+	}
+}
+
+void RenderGraph::releaseUnused() {
+	// Textures of the wrong size can never be used again, the rest get a while in case their pass comes back
+	bool released = false;
+	for (int i = (int)_textures.size() - 1; i >= 0; i--) {
+		PooledTexture& pooled = _textures[i];
+		if (pooled.used) continue;
+		pooled.unusedFrames++;
+		bool stale = true;
+		for (int t = 1; t < _schedule.getTargetCount(); t++) {
+			int width, height;
+			_schedule.getTargetSize(t, width, height);
+			if (_schedule.getFormat(t) == pooled.format && width == pooled.width && height == pooled.height) {
+				stale = false;
+				break;
+			}
+		}
+		if (!stale && pooled.unusedFrames <= RELEASE_FRAMES) continue;
+
+		delete pooled.texture;
+		_textures.erase(_textures.begin() + i);
+		for (Target& target : _targets) {
+			if (target.texture > i) target.texture--;
+		}
+		released = true;
+	}
+
+	// GL can hand a deleted texture's name to the next one, so framebuffers can't be trusted after a release
+	if (released) {
+		for (Pass& pass : _passes) {
+			delete pass.fbo;
+			pass.fbo = nullptr;
+			pass.fboTextures.clear();
+		}
+	}
+}
+
+void RenderGraph::execute() {
+	for (int p = 0; p < (int)_passes.size(); p++) {
+		if (!_schedule.isPassActive(p)) continue;
+		bindPass(p);
+		_passes[p].execute();
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderGraph::bindPass(int p) {
+	Pass& pass = _passes[p];
+	const vector<int>& writes = _schedule.getWrites(p);
+	const vector<int>& clears = _schedule.getClears(p);
+	bool backbuffer = std::find(writes.begin(), writes.end(), BACKBUFFER) != writes.end();
+	int width, height;
+	_schedule.getTargetSize(BACKBUFFER, width, height);
+	if (backbuffer) {
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		if (!clears.empty()) {
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		}
+	}
+	else {
+		vector<int> textures;
+		for (int target : writes) {
+			textures.push_back(_targets[target].texture);
+		}
+		if (pass.fbo == nullptr || textures != pass.fboTextures) {
+			delete pass.fbo;
+			vector<GLTexture*> colors;
+			GLTexture* depth = nullptr;
+			for (int target : writes) {
+				GLTexture* texture = _textures[_targets[target].texture].texture;
+				if (RenderGraphSchedule::isDepthFormat(_schedule.getFormat(target))) {
+					depth = texture;
+				}
+				else {
+					colors.push_back(texture);
+				}
+			}
+			int fboWidth, fboHeight;
+			_schedule.getTargetSize(writes[0], fboWidth, fboHeight);
+			pass.fbo = new FrameBufferObject(fboWidth, fboHeight, colors, depth);
+			pass.fboTextures = textures;
+		}
+		pass.fbo->bind();
+		width = pass.fbo->getWidth();
+		height = pass.fbo->getHeight();
+
+		// Clear only what this pass is the first to write, later passes draw over earlier results
+		int drawBuffer = 0;
+		const GLfloat black[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for (int target : writes) {
+			bool depth = RenderGraphSchedule::isDepthFormat(_schedule.getFormat(target));
+			if (std::find(clears.begin(), clears.end(), target) != clears.end()) {
+				if (depth) {
+					glClearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0);
+				}
+				else {
+					glClearBufferfv(GL_COLOR, drawBuffer, black);
+				}
+			}
+			if (!depth) drawBuffer++;
+		}
+		RenderUtil::checkGLError("RenderGraph::bindPass");
+	}
+	glViewport(0, 0, width, height);
+}
+
+size_t RenderGraph::bytesPerPixel(GLenum format) {
+	switch (format) {
+	case GL_RGBA32F:
+		return 16;
+	case GL_RGBA16F:
+		return 8;
+	default:
+		return 4;
+	}
+}
\ No newline at end of file
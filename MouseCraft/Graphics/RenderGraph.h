@@ -0,0 +1,137 @@
+#pragma once
+#include "../GL/glad.h"
+#include "GLTexture.h"
+#include "BufferObjects/FrameBufferObject.h"
+#include "RenderGraphSchedule.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Describes a frame as passes which read and write render targets.
+/// Each frame the graph drops passes that are disabled or whose output nothing reads,
+/// works out the first and last pass to use every target, and lets targets whose lifetimes
+/// don't overlap share one texture. Targets only exist while a pass that writes them runs,
+/// and are sized relative to the backbuffer so they follow the window when it changes size
+/// and the render scale when it changes.
+/// The scheduling is done by a RenderGraphSchedule, this backs its slots with pooled textures
+/// and runs the passes. Must be used on the thread that owns the GL context.
+/// </summary>
+class RenderGraph {
+public:
+	/// <summary>
+	/// The window's framebuffer. Every graph has it, and passes that write it are never culled.
+	/// </summary>
+	static const int BACKBUFFER = RenderGraphSchedule::BACKBUFFER;
+
+	RenderGraph();
+	~RenderGraph();
+
+	/// <summary>
+	/// Declare a render target
+	/// </summary>
+	/// <param name="name">A name for debugging</param>
+	/// <param name="format">The internal format, GL_DEPTH24_STENCIL8 for a depth target</param>
+	/// <param name="scale">The size of the target as a fraction of the backbuffer</param>
+	/// <returns>The ID passes use to refer to the target</returns>
+	int addTarget(const std::string& name, GLenum format, float scale = 1.0f);
+
+	/// <summary>
+	/// Declare a pass. Passes run in the order they are added.
+	/// The pass's framebuffer is bound with the viewport set before execute is called, and
+	/// targets the pass is the first to write are cleared. A pass may write one depth target
+	/// and any number of color targets, all the same size, or the backbuffer alone.
+	/// </summary>
+	/// <param name="name">A name for debugging</param>
+	/// <param name="reads">The targets the pass samples or depth tests against</param>
+	/// <param name="writes">The targets the pass draws to</param>
+	/// <param name="execute">Draws the pass</param>
+	/// <returns>The ID of the pass</returns>
+	int addPass(const std::string& name, const std::vector<int>& reads, const std::vector<int>& writes, std::function<void()> execute);
+
+	/// <summary>
+	/// Enable or disable a pass for the frames to come. Disabled passes are culled along with
+	/// any pass that only feeds them.
+	/// </summary>
+	void setPassEnabled(int pass, bool enabled);
+
+	/// <summary>
+	/// Set the size of the backbuffer. Targets are reallocated on the next compile if it changed.
+	/// </summary>
+	void setBackbufferSize(int width, int height);
+
+	/// <summary>
+	/// Scale every target other than the backbuffer by a further factor, for rendering below the
+	/// window's resolution. Passes that sample the targets into the backbuffer upscale them.
+	/// Targets are reallocated on the next compile if it changed.
+	/// </summary>
+	/// <param name="scale">The factor, clamped to (0, 1]</param>
+	void setRenderScale(float scale);
+
+	/// <summary>
+	/// Cull passes, compute target lifetimes and assign textures to targets, creating any that are missing.
+	/// Call after the frame's passes are enabled and before execute.
+	/// </summary>
+	void compile();
+
+	/// <summary>
+	/// Run every pass that survived compile, in order
+	/// </summary>
+	void execute();
+
+	/// <summary>
+	/// Check whether a pass survived the last compile
+	/// </summary>
+	bool isPassActive(int pass);
+
+	/// <summary>
+	/// Get the texture behind a target for sampling
+	/// </summary>
+	/// <param name="target">A target ID from addTarget</param>
+	/// <returns>The texture, or null if no active pass writes the target this frame</returns>
+	GLTexture* getTexture(int target);
+
+	/// <summary>
+	/// Get the size a target has this frame
+	/// </summary>
+	void getTargetSize(int target, int& width, int& height);
+
+	/// <summary>
+	/// Get the number of bytes held by the textures backing the targets
+	/// </summary>
+	size_t getTargetMemory();
+private:
+	struct Target {
+		std::string name;
+		// Index into _textures, -1 if the target isn't written this frame
+		int texture;
+	};
+
+	struct Pass {
+		std::string name;
+		std::function<void()> execute;
+		// Rebuilt whenever the textures behind the writes change
+		FrameBufferObject* fbo;
+		std::vector<int> fboTextures;
+	};
+
+	// A texture that backs one schedule slot a frame. Kept across frames and released once unused for a while.
+	struct PooledTexture {
+		GLTexture* texture;
+		GLenum format;
+		int width;
+		int height;
+		bool used;
+		int unusedFrames;
+	};
+
+	void assignTextures();
+	void releaseUnused();
+	void bindPass(int p);
+	static size_t bytesPerPixel(GLenum format);
+
+	RenderGraphSchedule _schedule;
+	std::vector<Target> _targets;
+	std::vector<Pass> _passes;
+	std::vector<PooledTexture> _textures;
+};
\ No newline at end of file
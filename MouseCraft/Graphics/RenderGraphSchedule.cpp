@@ -0,0 +1,192 @@
+#include "RenderGraphSchedule.h"
+#include <algorithm>
+#include <cmath>
+
+using std::vector;
+
+const int RenderGraphSchedule::BACKBUFFER;
+
+RenderGraphSchedule::RenderGraphSchedule() : _backbufferWidth(1), _backbufferHeight(1), _renderScale(1.0f) {
+	addTarget(GL_RGBA8);
+}
+
+int RenderGraphSchedule::addTarget(GLenum format, float scale) {
+	Target target;
+	target.format = format;
+	target.scale = scale;
+	target.width = target.height = 0;
+	target.slot = -1;
+	target.firstUse = target.lastUse = -1;
+	_targets.push_back(target);
+	return _targets.size() - 1;
+}
+
+int RenderGraphSchedule::addPass(const vector<int>& reads, const vector<int>& writes) {
+	Pass pass;
+	pass.reads = reads;
+	pass.writes = writes;
+	pass.enabled = true;
+	pass.active = false;
+	_passes.push_back(pass);
+	return _passes.size() - 1;
+}
+
+void RenderGraphSchedule::setPassEnabled(int pass, bool enabled) {
+	_passes[pass].enabled = enabled;
+}
+
+void RenderGraphSchedule::setBackbufferSize(int width, int height) {
+	_backbufferWidth = std::max(width, 1);
+	_backbufferHeight = std::max(height, 1);
+}
+
+void RenderGraphSchedule::setRenderScale(float scale) {
+	_renderScale = std::min(std::max(scale, 0.01f), 1.0f);
+}
+
+bool RenderGraphSchedule::isPassActive(int pass) {
+	return _passes[pass].active;
+}
+
+const vector<int>& RenderGraphSchedule::getWrites(int pass) {
+	return _passes[pass].writes;
+}
+
+const vector<int>& RenderGraphSchedule::getClears(int pass) {
+	return _passes[pass].clears;
+}
+
+int RenderGraphSchedule::getSlot(int target) {
+	return _targets[target].slot;
+}
+
+const vector<RenderGraphSchedule::Slot>& RenderGraphSchedule::getSlots() {
+	return _slots;
+}
+
+int RenderGraphSchedule::getTargetCount() {
+	return _targets.size();
+}
+
+GLenum RenderGraphSchedule::getFormat(int target) {
+	return _targets[target].format;
+}
+
+void RenderGraphSchedule::getTargetSize(int target, int& width, int& height) {
+	width = _targets[target].width;
+	height = _targets[target].height;
+}
+
+void RenderGraphSchedule::getLifetime(int target, int& firstUse, int& lastUse) {
+	firstUse = _targets[target].firstUse;
+	lastUse = _targets[target].lastUse;
+}
+
+void RenderGraphSchedule::compile() {
+	sizeTargets();
+	cullPasses();
+	computeLifetimes();
+	assignSlots();
+}
+
+void RenderGraphSchedule::sizeTargets() {
+	_targets[BACKBUFFER].width = _backbufferWidth;
+	_targets[BACKBUFFER].height = _backbufferHeight;
+	for (size_t t = 1; t < _targets.size(); t++) {
+		Target& target = _targets[t];
+		float scale = target.scale * _renderScale;
+		target.width = std::max(1, (int)std::lround(_backbufferWidth * scale));
+		target.height = std::max(1, (int)std::lround(_backbufferHeight * scale));
+	}
+}
+
+void RenderGraphSchedule::cullPasses() {
+	// Walk back from the backbuffer, a pass survives if a later surviving pass reads what it writes
+	vector<bool> needed(_targets.size(), false);
+	needed[BACKBUFFER] = true;
+	for (int p = (int)_passes.size() - 1; p >= 0; p--) {
+		Pass& pass = _passes[p];
+		pass.active = false;
+		if (!pass.enabled) continue;
+		for (int target : pass.writes) {
+			if (needed[target]) {
+				pass.active = true;
+				break;
+			}
+		}
+		if (!pass.active) continue;
+		for (int target : pass.reads) {
+			needed[target] = true;
+		}
+	}
+}
+
+void RenderGraphSchedule::computeLifetimes() {
+	// A target lives from its first active writer to its last active reader. Reads of a
+	// target nothing writes this frame don't keep it alive, the reader gets no texture.
+	for (Target& target : _targets) {
+		target.firstUse = target.lastUse = -1;
+	}
+	for (int p = 0; p < (int)_passes.size(); p++) {
+		Pass& pass = _passes[p];
+		pass.clears.clear();
+		if (!pass.active) continue;
+		for (int target : pass.writes) {
+			Target& t = _targets[target];
+			if (t.firstUse < 0) {
+				t.firstUse = p;
+				pass.clears.push_back(target);
+			}
+			t.lastUse = p;
+		}
+		for (int target : pass.reads) {
+			Target& t = _targets[target];
+			if (t.firstUse >= 0) {
+				t.lastUse = p;
+			}
+		}
+	}
+}
+
+void RenderGraphSchedule::assignSlots() {
+	_slots.clear();
+
+	// Hand out slots in the order targets start, reusing any whose last user has finished
+	vector<int> order;
+	for (int t = 1; t < (int)_targets.size(); t++) {
+		_targets[t].slot = -1;
+		if (_targets[t].firstUse >= 0) {
+			order.push_back(t);
+		}
+	}
+	std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+		return _targets[a].firstUse < _targets[b].firstUse;
+	});
+
+	for (int t : order) {
+		Target& target = _targets[t];
+		int found = -1;
+		for (int i = 0; i < (int)_slots.size(); i++) {
+			const Slot& slot = _slots[i];
+			if (slot.format == target.format && slot.width == target.width && slot.height == target.height &&
+				slot.busyUntil < target.firstUse) {
+				found = i;
+				break;
+			}
+		}
+		if (found < 0) {
+			Slot slot;
+			slot.format = target.format;
+			slot.width = target.width;
+			slot.height = target.height;
+			found = _slots.size();
+			_slots.push_back(slot);
+		}
+		_slots[found].busyUntil = target.lastUse;
+		target.slot = found;
+	}
+}
+
+bool RenderGraphSchedule::isDepthFormat(GLenum format) {
+	return format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH_COMPONENT24 || format == GL_DEPTH_COMPONENT32F;
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+#pragma once
+#include "../GL/glad.h"
+#include <vector>
+
+/// <summary>
+/// The scheduling half of the RenderGraph, which makes no GL calls so it can be tested on its own.
+/// It drops passes that are disabled or whose output nothing reads, works out the first and
+/// last pass to use every target, and puts each target in a slot. Targets of the same format
+/// and size whose lifetimes don't overlap share a slot, and the graph backs each slot with one texture.
+/// </summary>
+class RenderGraphSchedule {
+public:
+	/// <summary>
+	/// The window's framebuffer. Passes that write it are never culled, and it never gets a slot.
+	/// </summary>
+	static const int BACKBUFFER = 0;
+
+	/// <summary>
+	/// One texture's worth of storage shared by targets that are never alive at the same time
+	/// </summary>
+	struct Slot {
+		GLenum format;
+		int width;
+		int height;
+		// The last active pass to use any target in the slot
+		int busyUntil;
+	};
+
+	RenderGraphSchedule();
+
+	/// <summary>
+	/// Declare a render target
+	/// </summary>
+	/// <param name="format">The internal format, GL_DEPTH24_STENCIL8 for a depth target</param>
+	/// <param name="scale">The size of the target as a fraction of the backbuffer</param>
+	/// <returns>The ID passes use to refer to the target</returns>
+	int addTarget(GLenum format, float scale = 1.0f);
+
+	/// <summary>
+	/// Declare a pass. Passes run in the order they are added.
+	/// </summary>
+	/// <param name="reads">The targets the pass samples or depth tests against</param>
+	/// <param name="writes">The targets the pass draws to</param>
+	/// <returns>The ID of the pass</returns>
+	int addPass(const std::vector<int>& reads, const std::vector<int>& writes);
+
+	/// <summary>
+	/// Enable or disable a pass. Disabled passes are culled along with any pass that only feeds them.
+	/// </summary>
+	void setPassEnabled(int pass, bool enabled);
+
+	/// <summary>
+	/// Set the size of the backbuffer, which every other target's size is relative to
+	/// </summary>
+	void setBackbufferSize(int width, int height);
+
+	/// <summary>
+	/// Scale every target other than the backbuffer by a further factor
+	/// </summary>
+	/// <param name="scale">The factor, clamped to (0, 1]</param>
+	void setRenderScale(float scale);
+
+	/// <summary>
+	/// Size the targets, cull passes, compute target lifetimes and assign slots
+	/// </summary>
+	void compile();
+
+	/// <summary>
+	/// Check whether a pass survived the last compile
+	/// </summary>
+	bool isPassActive(int pass);
+
+	/// <summary>
+	/// Get the targets a pass draws to
+	/// </summary>
+	const std::vector<int>& getWrites(int pass);
+
+	/// <summary>
+	/// Get the targets a pass is the first to write this frame, which it clears before drawing
+	/// </summary>
+	const std::vector<int>& getClears(int pass);
+
+	/// <summary>
+	/// Get the slot a target was put in
+	/// </summary>
+	/// <returns>An index into getSlots, or -1 if no active pass writes the target</returns>
+	int getSlot(int target);
+
+	/// <summary>
+	/// Get the slots from the last compile, in the order their first target starts
+	/// </summary>
+	const std::vector<Slot>& getSlots();
+
+	/// <summary>
+	/// Get the number of targets, counting the backbuffer
+	/// </summary>
+	int getTargetCount();
+
+	/// <summary>
+	/// Get the internal format of a target
+	/// </summary>
+	GLenum getFormat(int target);
+
+	/// <summary>
+	/// Get the size a target has after the last compile
+	/// </summary>
+	void getTargetSize(int target, int& width, int& height);
+
+	/// <summary>
+	/// Get the first and last active pass to use a target, both -1 if nothing writes it
+	/// </summary>
+	void getLifetime(int target, int& firstUse, int& lastUse);
+
+	/// <summary>
+	/// Check whether a format is attached as depth rather than color
+	/// </summary>
+	static bool isDepthFormat(GLenum format);
+private:
+	struct Target {
+		GLenum format;
+		float scale;
+		int width;
+		int height;
+		int slot;
+		int firstUse;
+		int lastUse;
+	};
+
+	struct Pass {
+		std::vector<int> reads;
+		std::vector<int> writes;
+		bool enabled;
+		bool active;
+		std::vector<int> clears;
+	};
+
+	void sizeTargets();
+	void cullPasses();
+	void computeLifetimes();
+	void assignSlots();
+
+	std::vector<Target> _targets;
+	std::vector<Pass> _passes;
+	std::vector<Slot> _slots;
+	int _backbufferWidth;
+	int _backbufferHeight;
+	float _renderScale;
+};
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include "Geometry.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+
+/// <summary>
+/// A single queued draw. Plain data so a frame's worth can be collected into
+/// reused arrays without allocating. Transforms are stored separately and referenced by index.
+/// </summary>
+struct RenderPacket {
+	/// <summary>
+	/// Orders packets for drawing, packets with equal keys can be drawn together
+	/// </summary>
+	uint64_t sortKey;
+
+	/// <summary>
+	/// The geometry to draw, resolved to its arena location by the MeshRegistry
+	/// </summary>
+	Geometry* geometry;
+
+	/// <summary>
+	/// The layer of the texture array to sample
+	/// </summary>
+	int textureID;
+
+	/// <summary>
+	/// Index into the frame's transform array
+	/// </summary>
+	uint32_t transformIndex;
+
+	/// <summary>
+	/// The tint, outlines store the line width in alpha
+	/// </summary>
+	glm::vec4 color;
+};
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include "Geometry.h"
+#include <glm/glm.hpp>
+#include <string>
+
+/// <summary>
+/// The renderer's retained copy of a Renderable. It's refreshed only when the renderable's
+/// transform, model, texture or color changes, so unchanged renderables cost a few compares per frame.
+/// </summary>
+struct RenderProxy {
+	/// <summary>
+	/// The world transformation when the proxy was last refreshed
+	/// </summary>
+	glm::mat4 world;
+
+	/// <summary>
+	/// The world space bounding sphere and box half extents of the full detail geometry
+	/// </summary>
+	glm::vec3 center;
+	float radius;
+	glm::vec3 extents;
+
+	/// <summary>
+	/// The tint, converted for the instance data
+	/// </summary>
+	glm::vec4 color;
+
+	/// <summary>
+	/// The atlas region of the model's texture, -1 until it's loaded
+	/// </summary>
+	int textureID = -1;
+
+	/// <summary>
+	/// What the proxy was built from, compared every frame to catch changes
+	/// </summary>
+	unsigned int transformVersion = 0;
+	Geometry* geometry = nullptr;
+	std::string* texture = nullptr;
+
+	/// <summary>
+	/// Set by the renderable when its model or color is replaced
+	/// </summary>
+	bool dirty = true;
+};
\ No newline at end of file
@@ -7,10 +7,34 @@
 #include "../UI/UIComponent.h"
 #include "ModelGen.h"
 #include "../Loading/ImageLoader.h"
-#include "RenderUtil.h"
+#include "../Loading/TextureCache.h"
 #include "OutlineComponent.h"
-
+#include "GLRenderBackend.h"
+#include "NullRenderBackend.h"
+#include "MeshIDPool.h"
+#include "../Core/TaskScheduler.h"
+#include "../Core/EngineMetrics.h"
+#include <cfloat>
+#include <iostream>
+
+// Texture atlas layers are TEXTURE_SIZE square and hold cells down to MIN_TEXTURE_SIZE
 #define TEXTURE_SIZE 2048
+#define MIN_TEXTURE_SIZE 16
+#define TEXTURE_PAGES 2
+#define EXTRACT_CHUNK_SIZE 256
+// Shader programs as they appear in sort keys, the backend maps them to its own
+#define GBUFFER_SHADER 0
+#define OUTLINE_SHADER 1
+#define UI_SHADER 2
+// Light clusters are tiles across and down the screen and exponential depth slices
+#define CLUSTER_TILES_X 16
+#define CLUSTER_TILES_Y 9
+#define CLUSTER_SLICES 24
+// Lights are cut off once they'd add less than this to a pixel
+#define LIGHT_CUTOFF (1.0f / 256.0f)
+// Models drop to LOD 1 once their bounding sphere is smaller than this fraction of the screen
+// height, and down another level each time it halves again
+#define LOD_SCREEN_SIZE 0.25f
 
 using std::string;
 using std::vector;
@@ -23,462 +47,312 @@ using glm::identity;
 using glm::inverse;
 using glm::transpose;
 
-RenderSystem::RenderSystem() : System() {
-	initShaders();
-	initVertexBuffers();
-	initTextures();
-	initRenderBuffers();
-
+RenderSystem::RenderSystem() : System(), _window(nullptr), _aspectRatio(16.0f / 9.0f), _renderThread(nullptr), _camera(nullptr) {
+	_textures = new TextureAtlas(TEXTURE_SIZE, MIN_TEXTURE_SIZE);
+	_lightClusters = new LightClusters(CLUSTER_TILES_X, CLUSTER_TILES_Y, CLUSTER_SLICES);
 	_screenQuad = ModelGen::makeQuad(ModelGen::Axis::Z, 2, 2);
 
-	_renderingList = new vector<RenderData>();
-	_accumulatingList = new vector<RenderData>();
-
-	_uiRenderingList = new vector<RenderData>();
-	_uiAccumulatingList = new vector<RenderData>();
-
-	_lightRenderingList = new vector<LightData>();
-	_lightRenderingList->reserve(MAX_LIGHTS);
-	_lightAccumulatingList = new vector<LightData>();
-	_lightAccumulatingList->reserve(MAX_LIGHTS);
-
-	_outlineRenderingList = new vector<RenderData>();
-	_outlineAccumulatingList = new vector<RenderData>();
-
-	_masterGeometry = new CombinedGeometry();
-	_masterOutlineGeometry = new CombinedGeometry();
-
-	glEnable(GL_FRAMEBUFFER_SRGB);
-	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	_frame.clear();
+	_recording = &_buffers[0];
 
 	profiler.InitializeTimers(1);
-	profiler.LogOutput("Rendering.log");	// optional
+	profiler.LogOutput("RenderRecording.log");	// optional
 
 	loadTexture("res/models/test/blank.bmp");
-
-	_vao->bind();
 }
 
 RenderSystem::~RenderSystem() {
-	delete _vao;
-	delete _positionVBO;
-	delete _ebo;
+	// Stop replaying before anything the frames were recorded from goes away
+	delete _renderThread;
 	delete _textures;
-	delete _fbo;
-	delete _outlineFBO;
 	delete _screenQuad;
-	delete _masterGeometry;
-	delete _ubo;
-
-	for (auto a : *_staticGeometries) {
-		delete a;
-	}
-
-	for (auto a : *_staticTextures) {
-		delete a;
-	}
-}
-
-void RenderSystem::initVertexBuffers() {
-	_vao = new VertexArrayObject();
-	_positionVBO = new VertexBufferObject(3);
-	_normalVBO = new VertexBufferObject(3);
-	_texCoordVBO = new VertexBufferObject(2);
-	_ebo = new ElementBufferObject();
-
-	_vao->setBuffer(0, *_positionVBO);
-	_vao->setBuffer(1, *_normalVBO);
-	_vao->setBuffer(2, *_texCoordVBO);
-
-	_vao->setElementBuffer(*_ebo);
-}
-
-void RenderSystem::initTextures() {
-	_staticTextures = new vector<Image*>();
-	_textures = new GLTextureArray(TEXTURE_SIZE, TEXTURE_SIZE, 50, 5, GL_SRGB8_ALPHA8);
+	delete _lightClusters;
 }
 
-void RenderSystem::initRenderBuffers() {
-	_albedoBuffer = new GLTexture();
-	_normalBuffer = new GLTexture();
-	_positionBuffer = new GLTexture();
-	_outlineBuffer = new GLTexture();
-
-	vector<GLTexture*> buffers = { _albedoBuffer, _normalBuffer, _positionBuffer };
-	_fbo = new FrameBufferObject(1280, 720, buffers);
-
-	vector<GLTexture*> outlineBuffers = { _outlineBuffer };
-	_outlineFBO = new FrameBufferObject(1280, 720, outlineBuffers);
-
-	_fbo = new FrameBufferObject(1280, 720, buffers);
-
-
-	vector<GLTexture*> noBuffers = {};
-	_resizeInFBO = new FrameBufferObject(TEXTURE_SIZE, TEXTURE_SIZE, noBuffers);
-	_resizeOutFBO = new FrameBufferObject(TEXTURE_SIZE, TEXTURE_SIZE, noBuffers);
-
-	_ubo = new UniformBufferObject();
-}
-
-void RenderSystem::setWindow(Window* window) {
+void RenderSystem::setWindow(Window* window, const DynamicResolutionSettings& resolution) {
 	_window = window;
+	_aspectRatio = (float)window->getWidth() / window->getHeight();
+	// Hand the context over, the backend makes it current on the render thread
+	SDL_GL_MakeCurrent(window->getSDLWindow(), nullptr);
+	startRenderThread([window, resolution]() -> RenderBackend* {
+		return new GLRenderBackend(window, TEXTURE_SIZE, TEXTURE_PAGES, resolution);
+	});
 }
 
-void RenderSystem::initShaders() {
-	loadShader("gbuffer");
-	loadShader("lighting");
-	loadShader("outline");
-	loadShader("ui");
-}
-
-void RenderSystem::setShader(Shader& shader) {
-	glUseProgram(shader.getProgram());
-	_shader = &shader;
+void RenderSystem::setHeadless(int width, int height) {
+	_window = nullptr;
+	_aspectRatio = (float)width / height;
+	startRenderThread([]() -> RenderBackend* {
+		return new NullRenderBackend();
+	});
 }
 
-void RenderSystem::clearShader() {
-	glUseProgram(0);
-	_shader = nullptr;
+void RenderSystem::startRenderThread(RenderThread::BackendFactory factory) {
+	delete _renderThread;
+	_renderThread = new RenderThread(factory);
 }
 
 void RenderSystem::Update(float dt) {
-	profiler.StartTimer(0);
+	if (_renderThread == nullptr) return; // Nothing to draw to yet
 
-	clearBuffers();
-	renderScene();
+	// Minimized windows report no height, keep the last shape until they come back
+	if (_window != nullptr && _window->getHeight() > 0) {
+		_aspectRatio = (float)_window->getWidth() / _window->getHeight();
+	}
 
+	profiler.StartTimer(0);
+	_recording->releaseMeshes();
 	accumulateList();
-	swapLists();
-
+	sortLists();
+	recordFrame();
 	profiler.StopTimer(0);
+	EngineMetrics::Instance().Set("render.record.cpu_ms", profiler.GetDurationSec(0) * 1000.0);
 	profiler.FrameFinish();
-}
 
-void RenderSystem::clearBuffers() {
-	_fbo->bind();
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	_fbo->unbind();
-	_outlineFBO->bind();
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	_outlineFBO->unbind();
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	// Waits for the previous frame, so its buffer is free to record the next one into
+	_renderThread->submit(_recording);
+	_recording = _recording == &_buffers[0] ? &_buffers[1] : &_buffers[0];
+	_recording->clear();
 }
 
-void RenderSystem::renderScene() {
-	if (_camera != nullptr) {
-		float windowRatio = (float)_window->getWidth() / _window->getHeight();
-		Transform viewTransform = _camera->getTransform();
-		mat4 view = inverse(viewTransform.getWorldTransformation());
-
-		float fov = _camera->getFOV();
-		float closeClip = _camera->getCloseClip();
-		float farClip = _camera->getFarClip();
-
-		mat4 projection = perspective(fov, windowRatio, closeClip, farClip);
-
-		gBufferPass(view, projection);
-		outlinePass(view, projection);
-		makeLightsViewSpace(view);
-		lightingPass();
+void RenderSystem::recordFrame() {
+	RenderCommandBuffer& buffer = *_recording;
+	FrameData& frame = _frame;
+	buffer.textureLayers = _textures->getLayerCount();
+	buffer.beginFrame(frame.view, frame.projection);
+
+	// Draw from the camera the frame was collected for, which the lights were binned against
+	if (frame.hasCamera) {
+		buffer.beginBatches();
+		recordBatches(frame.scene);
+		buffer.drawBatches(RenderCommandBuffer::DRAW_SCENE);
+
+		buffer.beginBatches();
+		recordBatches(frame.outlines);
+		buffer.drawBatches(RenderCommandBuffer::DRAW_OUTLINES);
+
+		// The light arrays trade places with the buffer's, so neither side reallocates
+		buffer.lights.swap(frame.lights);
+		buffer.clusterRanges.swap(frame.clusterRanges);
+		buffer.lightIndices.swap(frame.lightIndices);
+
+		LightingParams params;
+		params.quadMeshID = getMeshID(_screenQuad->getGeometry());
+		params.globalLights = frame.globalLights;
+		params.ambientColor = vec3(0.06f, 0.17f, 0.27f);
+		params.clusterGrid = _lightClusters->getGrid();
+		params.clusterDepthScale = _lightClusters->getDepthScale();
+		params.clusterDepthBias = _lightClusters->getDepthBias();
+		buffer.drawLighting(params);
 	}
-	uiPass();
-}
-
-void RenderSystem::gBufferPass(glm::mat4 viewMatrix, glm::mat4 projectionMatrix) {
 
-	// Set up all of the vertex data for all objects to be rendered
-	combineMasterGeometry(*_renderingList);
-	_positionVBO->buffer(_masterGeometry->getVertexData());
-	_normalVBO->buffer(_masterGeometry->getNormalData());
-	_texCoordVBO->buffer(_masterGeometry->getTexCoordData());
-	_ebo->buffer(_masterGeometry->getIndices());
+	// Everything goes into one stream in back to front order
+	for (const RenderPacket& packet : frame.ui) {
+		const mat4& model = frame.transforms[packet.transformIndex];
 
-	setShader(_shaders["gbuffer"]);
-	_fbo->bind();
+		mat4 matrix = 2.0f * glm::translate(model, vec3(-0.5, -0.5, 0));
+		matrix[3][3] = 1.0f; // To fix the scaling to be what we want
 
-	int index = 0;
-	for (RenderData render : *_renderingList) {
-		int texID = getTexture(render.getModel()->getTexture());
-		vec4 color = convertColor(render.getColor());
-		mat4 model = render.getTransform();
+		buffer.addUI(packet.geometry, matrix, packet.color, _textures->getRegion(packet.textureID));
+	}
+	buffer.drawUI();
 
-		mat4 mv =  viewMatrix * model;
-		mat4 mvp = projectionMatrix * mv;
-		mat4 invMVP = transpose(inverse(viewMatrix * model));
+	frame.clear();
+}
 
-		int loc = _masterGeometry->getVertexStart(index);
-		_vao->setBuffer(0, *_positionVBO, loc * 3 * sizeof(GLfloat));
-		_vao->setBuffer(1, *_normalVBO, loc * 3 * sizeof(GLfloat));
-		_vao->setBuffer(2, *_texCoordVBO, loc * 2 * sizeof(GLfloat));
+void RenderSystem::recordBatches(const vector<RenderPacket>& packets) {
+	// Packets are already sorted, so runs with the same state bits share
+	// geometry and texture and each run becomes one instanced draw
+	for (size_t i = 0; i < packets.size(); i++) {
+		const RenderPacket& packet = packets[i];
+		bool newBatch = i == 0 || (packets[i - 1].sortKey & SortKey::STATE_MASK) != (packet.sortKey & SortKey::STATE_MASK);
+		_recording->addInstance(newBatch, packet.geometry->getMeshID(), _textures->getRegion(packet.textureID),
+			_frame.transforms[packet.transformIndex], packet.color);
+	}
+}
 
-		_textures->bind(GL_TEXTURE0);
+bool RenderSystem::getCameraMatrices(mat4& view, mat4& projection) {
+	if (_camera == nullptr) return false;
+	Transform viewTransform = _camera->getTransform();
+	view = inverse(viewTransform.getWorldTransformation());
 
-		_shader->setUniformVec3("color", color);
-		_shader->setUniformMatrix("transform", mvp);
-		_shader->setUniformMatrix("transformNoPerspective", mv);
-		_shader->setUniformMatrix("invTransform", invMVP);
+	float fov = _camera->getFOV();
+	float closeClip = _camera->getCloseClip();
+	float farClip = _camera->getFarClip();
 
-		_shader->setUniformInt("textureID", texID);
-		_shader->setUniformTexture("albedoTex", 0);
+	projection = perspective(fov, _aspectRatio, closeClip, farClip);
+	return true;
+}
 
-		int start = _masterGeometry->getIndexStart(index);
-		int size = _masterGeometry->getIndexEnd(index) - start + 1;
-		glDrawElements(GL_TRIANGLES, size, GL_UNSIGNED_INT, (void *)(start * sizeof(GLuint)));
+void RenderSystem::worldBounds(Geometry* g, const mat4& world, vec3& center, float& radius, vec3& extents) {
+	center = vec3(world * vec4(g->getBoundsCenter(), 1.0f));
+	float scale = std::max(glm::length(vec3(world[0])), std::max(glm::length(vec3(world[1])), glm::length(vec3(world[2]))));
+	radius = g->getBoundsRadius() * scale;
+	glm::mat3 absWorld(glm::abs(vec3(world[0])), glm::abs(vec3(world[1])), glm::abs(vec3(world[2])));
+	extents = absWorld * ((g->getBoundsMax() - g->getBoundsMin()) * 0.5f);
+}
 
-		index++;
+bool RenderSystem::refreshProxy(Renderable* r) {
+	RenderProxy& proxy = r->getProxy();
+	const Transform& transform = r->GetEntity()->transform;
+	Model* m = r->getModel();
+	if (!proxy.dirty && proxy.transformVersion == transform.getWorldVersion() &&
+		proxy.geometry == m->getGeometry() && proxy.texture == m->getTexture()) return false;
+
+	proxy.world = transform.getWorldTransformation();
+	proxy.transformVersion = transform.getWorldVersion();
+	proxy.geometry = m->getGeometry();
+	worldBounds(proxy.geometry, proxy.world, proxy.center, proxy.radius, proxy.extents);
+	if (proxy.dirty || proxy.texture != m->getTexture()) {
+		proxy.texture = m->getTexture();
+		proxy.color = convertColor(r->getColor());
+		// Only read the texture table here, anything not loaded yet
+		// is finished on the main thread since loading records into the frame
+		proxy.textureID = findTexture(proxy.texture);
+		proxy.dirty = false;
 	}
-	_fbo->unbind();
+	return true;
 }
 
-void RenderSystem::combineMasterGeometry(vector<RenderData>& data) {
-	_masterGeometry->clear();
-	std::vector<GLfloat>& vert = _masterGeometry->getVertexData();
-	std::vector<GLfloat>& texCoord = _masterGeometry->getTexCoordData();
-	std::vector<GLfloat>& normal = _masterGeometry->getNormalData();
-	std::vector<GLuint>& indices = _masterGeometry->getIndices();
-	for (RenderData render : data) {
-		Geometry* g = render.getModel()->getGeometry();
-
-		int startVertex = vert.size() / 3;
-		int startIndex = indices.size();
-		_masterGeometry->getIndexIndices().push_back(startIndex);
-		_masterGeometry->getVertexIndices().push_back(startVertex);
-
-		vert.insert(vert.end(), g->getVertexData().begin(), g->getVertexData().end());
-		texCoord.insert(texCoord.end(), g->getTexCoordData().begin(), g->getTexCoordData().end());
-		normal.insert(normal.end(), g->getNormalData().begin(), g->getNormalData().end());
-		indices.insert(indices.end(), g->getIndices().begin(), g->getIndices().end());
+void RenderSystem::cullRange(const vector<Renderable*>& renderables, const Frustum& frustum, size_t begin, size_t end) {
+	if (begin >= end) return;
+	// Lay the proxies' bounding spheres out for the batched test
+	for (size_t i = begin; i < end; i++) {
+		Renderable* r = renderables[i];
+		if (!_visible[i]) {
+			_cullX[i] = _cullY[i] = _cullZ[i] = _cullRadius[i] = 0.0f;
+			continue;
+		}
+		const RenderProxy& proxy = r->getProxy();
+		_cullX[i] = proxy.center.x;
+		_cullY[i] = proxy.center.y;
+		_cullZ[i] = proxy.center.z;
+		_cullRadius[i] = proxy.radius;
 	}
-	_masterGeometry->setVertexData(vert);
-	_masterGeometry->setTexCoordData(texCoord);
-	_masterGeometry->setNormalData(normal);
-	_masterGeometry->setIndices(indices);
-}
 
-vector<GLfloat>* RenderSystem::fetchSmoothNormals(Geometry* g) {
-	if (_smoothNormalCache.find(g) == _smoothNormalCache.end()) {
-		_smoothNormalCache[g] = calcSmoothNormals(g);
+	frustum.cullSpheres(&_cullX[begin], &_cullY[begin], &_cullZ[begin], &_cullRadius[begin], &_visible[begin], end - begin);
+
+	// Spheres are loose around long thin models, so test the survivors' boxes too
+	for (size_t i = begin; i < end; i++) {
+		if (!_visible[i]) continue;
+		const RenderProxy& proxy = renderables[i]->getProxy();
+		_visible[i] = proxy.radius > 0.0f && frustum.intersectsBox(proxy.center, proxy.extents) ? 1 : 0;
 	}
-	return _smoothNormalCache[g];
 }
 
-std::vector<GLfloat>* RenderSystem::calcSmoothNormals(Geometry* geometry) {
-	std::vector<GLfloat> normals = geometry->getNormalData();
-	std::vector<GLfloat> vertices = geometry->getVertexData();
-	std::map<std::vector<int>, std::pair<glm::vec3, std::vector<size_t>>> vertexIndexNormals;
-	size_t size = normals.size();
-
-	// Calculate the smooth normals
-	for (int i = 0; i < size; i += 3) {
-		std::vector<GLfloat> vertex = std::vector<GLfloat>(vertices.begin() + i, vertices.begin() + (i + 3));
-		std::vector<GLfloat> normal = std::vector<GLfloat>(normals.begin() + i, normals.begin() + (i + 3));
+Geometry* RenderSystem::selectLOD(Geometry* geometry, const RenderProxy& proxy, const ExtractParams& params) {
+	int levels = geometry->getLODCount();
+	if (levels == 1 || params.lodScale <= 0.0f) return geometry;
+	float distance = glm::distance(params.cameraPos, proxy.center);
+	float screenSize = distance > proxy.radius ? proxy.radius / distance * params.lodScale : FLT_MAX;
+	int level = 0;
+	for (float threshold = LOD_SCREEN_SIZE; level + 1 < levels && screenSize < threshold; threshold *= 0.5f) {
+		level++;
+	}
+	return geometry->getLOD(level);
+}
 
-		std::vector<int> vertInt = std::vector<int>();
-		for (GLfloat& f : vertex) {
-			vertInt.push_back((int)(round(f * 100.0f)));
+void RenderSystem::extractRange(const vector<Renderable*>& renderables, const ExtractParams& params, size_t begin, size_t end, ExtractChunk& out) {
+	out.transforms.clear();
+	out.scene.clear();
+	out.unresolved.clear();
+	out.updatedProxies = 0;
+
+	// Only renderables that changed since last frame do any real work here
+	for (size_t i = begin; i < end; i++) {
+		Renderable* r = renderables[i];
+		bool drawn = r->GetActive() && !StaticBatcher::isBatched(r);
+		_visible[i] = drawn ? 1 : 0;
+		if (drawn && refreshProxy(r)) {
+			out.updatedProxies++;
 		}
+	}
+	if (params.frustum != nullptr) {
+		cullRange(renderables, *params.frustum, begin, end);
+	}
 
-		std::vector<size_t>& indices = vertexIndexNormals[vertInt].second;
-		size_t size = indices.size();
-		if (size == 0) {
-			vertexIndexNormals[vertInt].first = glm::vec3(normal[0], normal[1], normal[2]);
+	for (size_t i = begin; i < end; i++) {
+		if (!_visible[i]) continue;
+		Renderable* r = renderables[i];
+		const RenderProxy& proxy = r->getProxy();
+
+		RenderPacket packet;
+		packet.geometry = selectLOD(proxy.geometry, proxy, params);
+		packet.transformIndex = out.transforms.size();
+		packet.color = proxy.color;
+		packet.textureID = proxy.textureID;
+		int meshID = packet.geometry->getMeshID();
+		if (packet.textureID >= 0 && meshID >= 0) {
+			float depth = glm::distance(params.cameraPos, vec3(proxy.world[3])) * params.depthScale;
+			packet.sortKey = SortKey::opaque(SortKey::GBUFFER, params.shader, packet.textureID, meshID, depth);
 		}
 		else {
-			glm::vec3& f = vertexIndexNormals[vertInt].first;
-			f = f * ((float)(size) / (size + 1.0f)) + vec3(normal[0], normal[1], normal[2]) * (1.0f / (size + 1.0f));
-		}
-		indices.push_back(i);
-	}
-
-	// Propogate the smooth normals back to the indices
-	std::vector<GLfloat>* smoothNormals = new std::vector<GLfloat>(normals);
-	for (auto& pair : vertexIndexNormals) {
-		std::vector<size_t> indices = pair.second.second;
-		glm::vec3 smoothNormal = normalize(pair.second.first);
-		//glm::vec3 smoothNormal = vec3(0.0f, 0.0f, 0.0f);
-		
-		for (size_t i : indices) {
-			(*smoothNormals)[i] = smoothNormal.x;
-			(*smoothNormals)[i + 1] = smoothNormal.y;
-			(*smoothNormals)[i + 2] = smoothNormal.z;
+			out.unresolved.push_back(std::make_pair(out.scene.size(), r));
 		}
+		out.transforms.push_back(proxy.world);
+		out.scene.push_back(packet);
 	}
-	return smoothNormals;
 }
 
-void RenderSystem::combineOutlineGeometry(vector<RenderData>& data) {
-	_masterOutlineGeometry->clear();
-	std::vector<GLfloat>& vert = _masterOutlineGeometry->getVertexData();
-	std::vector<GLfloat>& texCoord = _masterOutlineGeometry->getTexCoordData();
-	std::vector<GLfloat>& normal = _masterOutlineGeometry->getNormalData();
-	std::vector<GLuint>& indices = _masterOutlineGeometry->getIndices();
-	for (RenderData render : data) {
-		Geometry* g = render.getModel()->getGeometry();
-
-		int startVertex = vert.size() / 3;
-		int startIndex = indices.size();
-		_masterOutlineGeometry->getIndexIndices().push_back(startIndex);
-		_masterOutlineGeometry->getVertexIndices().push_back(startVertex);
-
-		std::vector<GLfloat>* smoothNormals = fetchSmoothNormals(g);
-
-		vert.insert(vert.end(), g->getVertexData().begin(), g->getVertexData().end());
-		texCoord.insert(texCoord.end(), g->getTexCoordData().begin(), g->getTexCoordData().end());
-		normal.insert(normal.end(), smoothNormals->begin(), smoothNormals->end());
-		indices.insert(indices.end(), g->getIndices().begin(), g->getIndices().end());
+void RenderSystem::extractStatic(const ExtractParams& params) {
+	FrameData& frame = _frame;
+	const mat4 identity(1.0f);
+	for (const StaticBatch& batch : _staticBatcher.getBatches()) {
+		Geometry* g = batch.geometry.get();
+		vec3 center, extents;
+		float radius;
+		worldBounds(g, identity, center, radius, extents);
+		if (params.frustum != nullptr &&
+			(!params.frustum->intersectsSphere(center, radius) || !params.frustum->intersectsBox(center, extents))) continue;
+
+		RenderPacket packet;
+		packet.geometry = g;
+		packet.textureID = getTexture(batch.texture);
+		packet.transformIndex = frame.transforms.size();
+		packet.color = batch.color;
+		float depth = glm::distance(params.cameraPos, center) * params.depthScale;
+		packet.sortKey = SortKey::opaque(SortKey::GBUFFER, params.shader, packet.textureID, getMeshID(g), depth);
+		frame.transforms.push_back(identity);
+		frame.scene.push_back(packet);
 	}
-	_masterOutlineGeometry->setVertexData(vert);
-	_masterOutlineGeometry->setTexCoordData(texCoord);
-	_masterOutlineGeometry->setNormalData(normal);
-	_masterOutlineGeometry->setIndices(indices);
 }
 
-void RenderSystem::makeLightsViewSpace(glm::mat4 viewMatrix) {
-	glm::mat4 normalMatrix = transpose(inverse(viewMatrix));
-	for (LightData& l : *_lightRenderingList) {
-		l.position = viewMatrix * l.position;
-		l.direction = normalMatrix * l.direction;
-	}
+void RenderSystem::sortLists() {
+	// The UI keys put back to front ordering first
+	SortKey::radixSort(_frame.scene, _sortScratch);
+	SortKey::radixSort(_frame.outlines, _sortScratch);
+	SortKey::radixSort(_frame.ui, _sortScratch);
 }
 
-void RenderSystem::outlinePass(glm::mat4 viewMatrix, glm::mat4 projectionMatrix) {
-	// Set up all of the vertex data for all objects to be rendered
-	combineOutlineGeometry(*_outlineRenderingList);
-	_positionVBO->buffer(_masterOutlineGeometry->getVertexData());
-	_normalVBO->buffer(_masterOutlineGeometry->getNormalData());
-	_texCoordVBO->buffer(_masterOutlineGeometry->getTexCoordData());
-	_ebo->buffer(_masterOutlineGeometry->getIndices());
-
-	setShader(_shaders["outline"]);
-
-	glCullFace(GL_FRONT);
-
-	// Blit the depth buffer from the gbuffer
-	//glClear(GL_DEPTH_BUFFER_BIT);
-	_outlineFBO->blit(*_fbo, _fbo->getWidth(), _fbo->getHeight(), GL_DEPTH_BUFFER_BIT);
-	RenderUtil::checkGLError("glBlitFramebuffer");
-	
-	_outlineFBO->bind();
-	int index = 0;
-	for (RenderData render : *_outlineRenderingList) {
-		vec4 color = convertColor(render.getColor());
-		color.a = 1.0f;
-		mat4 model = render.getTransform();
-
-		mat4 mv = viewMatrix * model;
-		mat4 mvp = projectionMatrix * mv;
-		mat4 invMVP = transpose(inverse(viewMatrix * model));
-
-		int loc = _masterOutlineGeometry->getVertexStart(index);
-		_vao->setBuffer(0, *_positionVBO, loc * 3 * sizeof(GLfloat));
-		_vao->setBuffer(1, *_normalVBO, loc * 3 * sizeof(GLfloat));
-		_vao->setBuffer(2, *_texCoordVBO, loc * 2 * sizeof(GLfloat));
-
-		_shader->setUniformVec3("color", color);
-		_shader->setUniformMatrix("transform", mvp);
-		_shader->setUniformFloat("lineWidth", render.getColor().getAlpha());
-
-		int start = _masterOutlineGeometry->getIndexStart(index);
-		int size = _masterOutlineGeometry->getIndexEnd(index) - start + 1;
-		glDrawElements(GL_TRIANGLES, size, GL_UNSIGNED_INT, (void *)(start * sizeof(GLuint)));
-
-		index++;
-	}
-	_outlineFBO->unbind();
-	glCullFace(GL_BACK);
+void RenderSystem::FrameData::clear() {
+	transforms.clear();
+	scene.clear();
+	outlines.clear();
+	ui.clear();
+	lights.clear();
+	globalLights = 0;
+	clusterRanges.clear();
+	lightIndices.clear();
+	hasCamera = false;
 }
 
-void RenderSystem::lightingPass() {
-	_vao->setBuffer(0, *_positionVBO);
-	_vao->setBuffer(1, *_normalVBO);
-	_vao->setBuffer(2, *_texCoordVBO);
-
-	Geometry* quad = _screenQuad->getGeometry();
-	setShader(_shaders["lighting"]);
-
-	_albedoBuffer->bind(GL_TEXTURE0);
-	_normalBuffer->bind(GL_TEXTURE1);
-	_positionBuffer->bind(GL_TEXTURE2);
-	_outlineBuffer->bind(GL_TEXTURE3);
-
-	_shader->setUniformTexture("albedoTex", 0);
-	_shader->setUniformTexture("normalTex", 1);
-	_shader->setUniformTexture("positionTex", 2);
-	_shader->setUniformTexture("outlineTex", 3);
-
-	_shader->setUniformInt("numLights", _lightRenderingList->size());
-	_shader->setUniformVec3("ambientColor", vec3(0.06f, 0.17f, 0.27f));
-
-	_ubo->bind(0);
-	_shader->setBindingPoint("Lights", 0);
-	_ubo->buffer((*_lightRenderingList)[0], MAX_LIGHTS);
-
-	_positionVBO->buffer(quad->getVertexData());
-	_normalVBO->buffer(quad->getNormalData());
-	_texCoordVBO->buffer(quad->getTexCoordData());
-	_ebo->buffer(quad->getIndices());
-	glDrawElements(GL_TRIANGLES, quad->getIndices().size(), GL_UNSIGNED_INT, 0);
-	_ubo->unbind(0);
+void RenderSystem::pushPacket(vector<RenderPacket>& packets, SortKey::Pass pass, unsigned int shader,
+	Model* model, uint32_t transformIndex, vec4 color, float depth) {
+	RenderPacket packet;
+	packet.geometry = model->getGeometry();
+	packet.textureID = getTexture(model->getTexture());
+	packet.transformIndex = transformIndex;
+	packet.color = color;
+	packet.sortKey = SortKey::opaque(pass, shader, packet.textureID, getMeshID(packet.geometry), depth);
+	packets.push_back(packet);
 }
 
-void RenderSystem::uiPass() {
-	glClear(GL_DEPTH_BUFFER_BIT);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	float windowRatio = (float)_window->getWidth() / _window->getHeight();
-
-	setShader(_shaders["ui"]);
-
-	int index = 0;
-	for (RenderData render : *_uiRenderingList) {
-		int texID = getTexture(render.getModel()->getTexture());
-		Geometry* g = render.getModel()->getGeometry();
-		vec4 color = convertColor(render.getColor());
-		mat4 model = render.getTransform();
-
-		mat4 matrix = 2.0f * glm::translate(model, vec3(-0.5, -0.5, 0));
-		matrix[3][3] = 1.0f; // To fix the scaling to be what we want
-
-		int loc = 0;
-		_vao->setBuffer(0, *_positionVBO, loc * 3 * sizeof(GLfloat));
-		_vao->setBuffer(1, *_normalVBO, loc * 3 * sizeof(GLfloat));
-		_vao->setBuffer(2, *_texCoordVBO, loc * 2 * sizeof(GLfloat));
-		
-		_positionVBO->buffer(g->getVertexData());
-		_normalVBO->buffer(g->getNormalData());
-		_texCoordVBO->buffer(g->getTexCoordData());
-		_ebo->buffer(g->getIndices());
-
-		_textures->bind(GL_TEXTURE0);
-
-		_shader->setUniformVec4("color", color);
-		_shader->setUniformMatrix("transform", matrix);
-
-		_shader->setUniformInt("textureID", texID);
-		_shader->setUniformTexture("tex", 0);
-
-		int start = 0;
-		int size = g->getIndices().size();
-		glDrawElements(GL_TRIANGLES, size, GL_UNSIGNED_INT, (void *)(start * sizeof(GLuint)));
-
-		index++;
+int RenderSystem::findTexture(string* path) {
+	if (path == nullptr) {
+		return 0; // Use the default texture
 	}
-	glDisable(GL_BLEND);
-}
-
-void RenderSystem::swapLists() {
-	swap(_renderingList, _accumulatingList);
-	swap(_uiRenderingList, _uiAccumulatingList);
-	// Sort the UI rendering list from back to front
-	std::sort(_uiRenderingList->begin(), _uiRenderingList->end(), [](RenderData a, RenderData b) {
-		return a.getTransform()[3][2] > b.getTransform()[3][2];
-	});
-	swap(_lightRenderingList, _lightAccumulatingList);
-	swap(_outlineRenderingList, _outlineAccumulatingList);
-	_accumulatingList->clear();
-	_uiAccumulatingList->clear();
-	_lightAccumulatingList->clear();
-	_outlineAccumulatingList->clear();
+	auto it = _texturePathToID.find(*path);
+	return it != _texturePathToID.end() ? it->second : -1;
 }
 
 int RenderSystem::getTexture(string* path) {
@@ -489,63 +363,40 @@ int RenderSystem::getTexture(string* path) {
 		_texturePathToID[*path] : loadTexture(*path);
 }
 
-int RenderSystem::loadTexture(const string& path, bool scale) {
-	Image* img = ImageLoader::loadImage(path);
-	if (scale) {
-		Image* tmp = img;
-		img = scaleImage(tmp, _textures->getWidth(), _textures->getHeight());
-		delete tmp;
+int RenderSystem::loadTexture(const string& path) {
+	// Mip chains are built on the CPU once and then read back from the cache on later runs
+	vector<MipLevel> levels;
+	if (!TextureCache::load(path, TEXTURE_SIZE, levels)) {
+		Image* img = ImageLoader::loadImage(path);
+		if (img == nullptr) {
+			// Fall back to the default texture instead of trying again every frame
+			_texturePathToID[path] = 0;
+			return 0;
+		}
+		int size = _textures->cellSize(img->getWidth(), img->getHeight());
+		levels = TextureFilter::buildMipChain(*img, size);
+		delete img;
+		TextureCache::save(path, TEXTURE_SIZE, levels);
 	}
-	int id = _staticTextures->size();
+	int layer, x, y;
+	int id = _textures->add(levels[0].width, levels.size(), layer, x, y);
+	if (id < 0) {
+		std::cerr << "Problem placing texture " << path << " in the atlas" << std::endl;
+		_texturePathToID[path] = 0;
+		return 0;
+	}
+	_recording->uploadTexture(layer, x, y, levels);
 	_texturePathToID[path] = id;
-	_staticTextures->push_back(img);
-	_textures->setImage(id, *img, GL_UNSIGNED_BYTE);
-	_textures->genMipmaps();
 	return id;
 }
 
-Image* RenderSystem::scaleImage(Image* input, int width, int height) {
-	GLTexture tmpTex, tmpTex2;
-	Image* tmpImg = new Image(NULL, width, height);
-
-	GLuint imageFormat = GL_RGBA8;
-	switch (input->getChannels()) {
-	case 1:
-		imageFormat = GL_R8;
-		break;
-	case 2:
-		imageFormat = GL_RG8;
-		break;
-	case 3:
-		imageFormat = GL_RGB8;
-		break;
+int RenderSystem::getMeshID(Geometry* geometry) {
+	// Geometry that is new or changed gets a fresh ID and a copy goes to the backend with this frame
+	if (geometry->getMeshID() < 0) {
+		geometry->setMeshID(MeshIDPool::instance().acquire());
+		_recording->uploadMesh(geometry->getMeshID(), geometry);
 	}
-	tmpTex.setImage(*input, false, imageFormat, GL_UNSIGNED_BYTE);
-	tmpTex2.setImage(*tmpImg, false, GL_RGBA8, GL_UNSIGNED_BYTE);
-	_resizeInFBO->buffer(GL_COLOR_ATTACHMENT0, tmpTex);
-	_resizeOutFBO->buffer(GL_COLOR_ATTACHMENT0, tmpTex2);
-	
-	_resizeOutFBO->blit(*_resizeInFBO, input->getWidth(), input->getHeight());
-
-	_resizeOutFBO->bind(GL_FRAMEBUFFER);
-	delete tmpImg;
-	std::vector<unsigned char>* data = new std::vector<unsigned char>(width * height * 4);
-	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &(*data)[0]);
-	RenderUtil::checkGLError("glReadPixels");
-	tmpImg = new Image(&(*data)[0], width, height, 4);
-	glClear(GL_DEPTH_BUFFER_BIT);
-
-	_resizeOutFBO->unbind(GL_FRAMEBUFFER);
-
-	return tmpImg;
-}
-
-bool RenderSystem::loadShader(string shaderName) {
-	static const string shaderPath = "res/shaders/";
-	string vsh = TextLoader::load(shaderPath + shaderName + ".vsh");
-	string fsh = TextLoader::load(shaderPath + shaderName + ".fsh");
-	_shaders[shaderName] = Shader(shaderName, vsh, fsh);
-	return _shaders[shaderName].compile();
+	return geometry->getMeshID();
 }
 
 vec4 RenderSystem::convertColor(Color c) {
@@ -553,73 +404,194 @@ vec4 RenderSystem::convertColor(Color c) {
 }
 
 void RenderSystem::accumulateList() {
-	auto renderables = ComponentManager<Renderable>::Instance().All();
-	auto uiRenderables = ComponentManager<UIComponent>::Instance().All();
-	auto cameras = ComponentManager<Camera>::Instance().All();
-	auto lights = ComponentManager<Light>::Instance().All();
-	for (Renderable* r : renderables) {
-		if (!r->GetActive()) continue;
-		Entity* e = r->GetEntity();
-		Transform t = r->getTransform();
-		_accumulatingList->push_back(
-			RenderData(
-				r->getModel(),
-				t.getWorldTransformation(),
-				r->getColor()
-			)
-		);
-		OutlineComponent* o = e->GetComponent<OutlineComponent>();
-		if (o != nullptr) {
-			Color c = o->getColor();
-			c.setAlpha(o->getWidth());
-			_outlineAccumulatingList->push_back(
-				RenderData(
-					r->getModel(),
-					t.getWorldTransformation(),
-					c
-				)
-			);
+	const auto& renderables = ComponentManager<Renderable>::Instance().All();
+	const auto& uiRenderables = ComponentManager<UIComponent>::Instance().All();
+	const auto& cameras = ComponentManager<Camera>::Instance().All();
+	const auto& lights = ComponentManager<Light>::Instance().All();
+	const auto& outlines = ComponentManager<OutlineComponent>::Instance().All();
+	FrameData& frame = _frame;
+	for (Camera* c : cameras) {
+		// Todo: Support for multiple cameras
+		// For now we will just take the first camera and leave;
+		_camera = c;
+		break;
+	}
+
+	// Skip everything outside the camera's view before building packets
+	mat4 view(1.0f), projection(1.0f);
+	bool hasCamera = getCameraMatrices(view, projection);
+	Frustum frustum(projection * view);
+
+	// Depth for sorting is the distance from the camera as a fraction of the far clip
+	ExtractParams params;
+	params.frustum = hasCamera ? &frustum : nullptr;
+	params.cameraPos = vec3(0.0f);
+	params.depthScale = 0.0f;
+	params.lodScale = 0.0f;
+	if (hasCamera) {
+		params.cameraPos = _camera->GetEntity()->transform.getWorldPosition();
+		params.depthScale = 1.0f / _camera->getFarClip();
+		params.lodScale = 1.0f / tanf(_camera->getFOV() * 0.5f);
+	}
+	params.shader = GBUFFER_SHADER;
+
+	// Extract the scene in parallel chunks, each into its own buffers
+	TaskScheduler& scheduler = TaskScheduler::instance();
+	size_t count = renderables.size();
+	size_t chunkCount = scheduler.ChunkCount(count, EXTRACT_CHUNK_SIZE);
+	if (_extractChunks.size() < chunkCount) {
+		_extractChunks.resize(chunkCount);
+	}
+	_cullX.resize(count);
+	_cullY.resize(count);
+	_cullZ.resize(count);
+	_cullRadius.resize(count);
+	_visible.resize(count);
+	scheduler.ParallelFor(count, EXTRACT_CHUNK_SIZE, [&](size_t begin, size_t end, size_t chunk) {
+		extractRange(renderables, params, begin, end, _extractChunks[chunk]);
+	});
+
+	// Each chunk's slice of the frame is known up front, so they copy in without locking
+	size_t transformCount = frame.transforms.size();
+	size_t packetCount = frame.scene.size();
+	size_t updatedProxies = 0;
+	for (size_t c = 0; c < chunkCount; c++) {
+		updatedProxies += _extractChunks[c].updatedProxies;
+		_extractChunks[c].transformBase = transformCount;
+		_extractChunks[c].packetBase = packetCount;
+		transformCount += _extractChunks[c].transforms.size();
+		packetCount += _extractChunks[c].scene.size();
+	}
+	frame.transforms.resize(transformCount);
+	frame.scene.resize(packetCount);
+	EngineMetrics::Instance().Set("render.proxy_updates", (double)updatedProxies);
+	scheduler.ParallelFor(chunkCount, 1, [&](size_t begin, size_t end, size_t) {
+		for (size_t c = begin; c < end; c++) {
+			ExtractChunk& chunk = _extractChunks[c];
+			std::copy(chunk.transforms.begin(), chunk.transforms.end(), frame.transforms.begin() + chunk.transformBase);
+			for (size_t i = 0; i < chunk.scene.size(); i++) {
+				RenderPacket& packet = frame.scene[chunk.packetBase + i];
+				packet = chunk.scene[i];
+				packet.transformIndex += chunk.transformBase;
+			}
+		}
+	});
+
+	// Load whatever the workers couldn't resolve
+	for (size_t c = 0; c < chunkCount; c++) {
+		for (auto& unresolved : _extractChunks[c].unresolved) {
+			RenderPacket& packet = frame.scene[_extractChunks[c].packetBase + unresolved.first];
+			const mat4& world = frame.transforms[packet.transformIndex];
+			float depth = glm::distance(params.cameraPos, vec3(world[3])) * params.depthScale;
+			if (packet.textureID < 0) {
+				RenderProxy& proxy = unresolved.second->getProxy();
+				proxy.textureID = packet.textureID = getTexture(proxy.texture);
+			}
+			packet.sortKey = SortKey::opaque(SortKey::GBUFFER, params.shader, packet.textureID, getMeshID(packet.geometry), depth);
 		}
 	}
+
+	// Static entities are drawn from their merged meshes, rebuilt only when the set changes
+	if (_staticBatcher.update(renderables)) {
+		EngineMetrics::Instance().Set("render.static_batches", (double)_staticBatcher.getBatches().size());
+	}
+	extractStatic(params);
+
+	// Outlines are rare, so look them up from their own components
+	for (OutlineComponent* o : outlines) {
+		Entity* e = o->GetEntity();
+		if (e == nullptr) continue;
+		Renderable* r = e->GetComponent<Renderable>();
+		if (r == nullptr || !r->GetActive()) continue;
+		// Static renderables skip extraction, so their proxy may not be current yet
+		refreshProxy(r);
+		const RenderProxy& proxy = r->getProxy();
+		const mat4& world = proxy.world;
+		if (hasCamera && (!frustum.intersectsSphere(proxy.center, proxy.radius) || !frustum.intersectsBox(proxy.center, proxy.extents))) continue;
+		uint32_t transformIndex = frame.transforms.size();
+		frame.transforms.push_back(world);
+		float depth = glm::distance(params.cameraPos, vec3(world[3])) * params.depthScale;
+		Color c = o->getColor();
+		c.setAlpha(o->getWidth());
+		pushPacket(frame.outlines, SortKey::OUTLINE, OUTLINE_SHADER, r->getModel(), transformIndex, convertColor(c), depth);
+	}
 	for (UIComponent* r : uiRenderables) {
-		Transform t = r->GetEntity()->transform;
-		vector<Model*> models = r->models;
-		Color c = r->color;
-		for (Model* m : models) {
-			_uiAccumulatingList->push_back(
-				RenderData(
-					m,
-					t.getWorldTransformation(),
-					c
-				)
+		uint32_t transformIndex = frame.transforms.size();
+		const mat4& world = r->GetEntity()->transform.getWorldTransformation();
+		frame.transforms.push_back(world);
+		vec4 color = convertColor(r->color);
+		for (Model* m : r->models) {
+			RenderPacket packet;
+			packet.geometry = m->getGeometry();
+			packet.textureID = getTexture(m->getTexture());
+			packet.transformIndex = transformIndex;
+			packet.color = color;
+			// UI is drawn back to front by its z
+			packet.sortKey = SortKey::transparent(SortKey::UI, UI_SHADER, packet.textureID, 0, world[3][2]);
+			frame.ui.push_back(packet);
+		}
+	}
+	frame.hasCamera = hasCamera;
+	frame.view = view;
+	frame.projection = projection;
+	collectLights(lights, frame);
+}
+
+void RenderSystem::collectLights(const vector<Light*>& lights, FrameData& frame) {
+	// Lights without a falloff light every pixel and go first, the rest are binned into clusters
+	_lightSpheres.clear();
+	for (int pass = 0; pass < 2; pass++) {
+		for (Light* l : lights) {
+			Entity* e = l->GetEntity();
+
+			LightData internalLight; // The light used by the rendering system
+			internalLight.type = l->getType();
+			internalLight.blank1 = 0;
+			internalLight.blank2 = 0;
+			internalLight.blank3 = 0;
+			internalLight.color = convertColor(l->getColor());
+			internalLight.attenuation = glm::vec4(
+				l->getConstantAttenuation(),
+				l->getLinearAttenuation(),
+				l->getQuadraticAttenuation(),
+				0.0f
 			);
+			internalLight.position = frame.view * glm::vec4(e->transform.getWorldPosition(), 1.0f);
+			internalLight.direction = glm::vec4(glm::mat3(frame.view) * e->transform.getWorldForward(), 1.0f);
+
+			float radius = lightRadius(internalLight);
+			bool global = radius == FLT_MAX;
+			if (global != (pass == 0)) continue;
+			if (!global) {
+				_lightSpheres.push_back(vec4(vec3(internalLight.position), radius));
+			}
+			frame.lights.push_back(internalLight);
+		}
+		if (pass == 0) {
+			frame.globalLights = frame.lights.size();
 		}
 	}
-	for (Camera* c : cameras) {
-		// Todo: Support for multiple cameras
-		// For now we will just take the first camera and leave;
-		_camera = c;
-		break;
+
+	if (frame.hasCamera) {
+		_lightClusters->setProjection(frame.projection, _camera->getCloseClip(), _camera->getFarClip());
+		_lightClusters->bin(_lightSpheres, frame.globalLights, frame.clusterRanges, frame.lightIndices);
+	}
+}
+
+float RenderSystem::lightRadius(const LightData& light) {
+	if (light.type == Light::LightType::Directional) return FLT_MAX;
+
+	// Solve for the distance where the light's brightest channel falls to the cutoff
+	float brightness = std::max(light.color.r, std::max(light.color.g, light.color.b));
+	float constant = light.attenuation.x - brightness / LIGHT_CUTOFF;
+	float linear = light.attenuation.y;
+	float quadratic = light.attenuation.z;
+	if (constant >= 0.0f) return 0.0f;
+	if (quadratic > 0.0f) {
+		return (-linear + sqrtf(linear * linear - 4.0f * quadratic * constant)) / (2.0f * quadratic);
 	}
-	for (int i = 0; i < lights.size() && i < MAX_LIGHTS; i++) {
-		Light* l = lights[i];
-		Entity* e = l->GetEntity();
-
-		LightData internalLight; // The light used by the rendering system
-		internalLight.type = l->getType();
-		internalLight.blank1 = 0;
-		internalLight.blank2 = 0;
-		internalLight.blank3 = 0;
-		internalLight.color = convertColor(l->getColor());
-		internalLight.attenuation = glm::vec4(
-			l->getConstantAttenuation(),
-			l->getLinearAttenuation(),
-			l->getQuadraticAttenuation(),
-			0.0f
-		);
-		internalLight.position = glm::vec4(e->transform.getWorldPosition(), 1.0f);
-		internalLight.direction = glm::vec4(e->transform.getWorldForward(), 1.0f);
-
-		_lightAccumulatingList->push_back(internalLight);
+	if (linear > 0.0f) {
+		return -constant / linear;
 	}
+	return FLT_MAX;
 }
\ No newline at end of file
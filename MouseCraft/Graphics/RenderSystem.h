@@ -1,115 +1,136 @@
 #pragma once
 #include "../Core/System.h"
 #include "Window.h"
+#include "DynamicResolution.h"
 #include <string>
 #include <vector>
 #include <glm/glm.hpp>
 #include <map>
-#include "Shader.h"
-#include "RenderData.h"
-#include "BufferObjects/VertexArrayObject.h"
-#include "BufferObjects/VertexBufferObject.h"
-#include "BufferObjects/ElementBufferObject.h"
-#include "BufferObjects/FrameBufferObject.h"
-#include "BufferObjects/UniformBufferObject.h"
-#include "CombinedGeometry.h"
+#include "Model.h"
+#include "RenderPacket.h"
+#include "SortKey.h"
+#include "Frustum.h"
+#include "RenderCommands.h"
+#include "RenderThread.h"
 #include "Camera.h"
-#include "GLTexture.h"
-#include "GLTextureArray.h"
+#include "TextureAtlas.h"
 #include "Light.h"
+#include "LightClusters.h"
+#include "StaticBatcher.h"
+#include "RenderProxy.h"
 #include "../Util/CpuProfiler.h"
 
-#define MAX_LIGHTS 50
+class Renderable;
 
 class RenderSystem : public System {
 public:
 	RenderSystem();
 	~RenderSystem();
-	void initVertexBuffers();
-	void initTextures();
-	void initRenderBuffers();
-	void setWindow(Window* window);
+	// Draw to a window. Its GL context moves to a render thread which replays the recorded frames.
+	// The scene renders below the window's resolution when it can't keep to the frame time in resolution.
+	void setWindow(Window* window, const DynamicResolutionSettings& resolution = DynamicResolutionSettings());
+	// Record frames without drawing them, for running without a window
+	void setHeadless(int width, int height);
 	void Update(float dt) override;
-	void swapLists();
-private:						        // Data Alignment
-	struct LightData {        // (Total: 16N)
-		Light::LightType type;	// 1N
-		int blank1;				// 1N
-		int blank2;				// 1N
-		int blank3;				// 1N
-		glm::vec4 color;		// 4N
-		glm::vec4 position;		// 4N
-		glm::vec4 direction;	// 4N
-		glm::vec4 attenuation;  // 4N (Constant, Linear, Quadratic, unused)
+private:
+	// What each extraction chunk needs to know about the camera
+	struct ExtractParams {
+		const Frustum* frustum; // nullptr to skip culling
+		glm::vec3 cameraPos;
+		float depthScale;
+		// 1 / tan(fov / 2), turns radius over distance into a fraction of the screen height. 0 draws full detail.
+		float lodScale;
+		unsigned int shader;
 	};
 
-	bool loadShader(std::string shaderName);
-	void initShaders();
-	void setShader(Shader& s);
-	void clearShader();
+	// One worker's share of the scene, copied into the frame afterwards
+	struct ExtractChunk {
+		std::vector<glm::mat4> transforms;
+		std::vector<RenderPacket> scene;
+		// Packets whose texture or mesh wasn't loaded yet, with the renderable to load for
+		std::vector<std::pair<size_t, Renderable*>> unresolved;
+		// Proxies refreshed because their renderable changed
+		size_t updatedProxies;
+		size_t transformBase;
+		size_t packetBase;
+	};
+
+	// Everything collected for one frame before it's recorded. Cleared rather than
+	// freed between frames so the arrays stop allocating once they've grown to fit the scene.
+	struct FrameData {
+		std::vector<glm::mat4> transforms;
+		std::vector<RenderPacket> scene;
+		std::vector<RenderPacket> outlines;
+		std::vector<RenderPacket> ui;
+		// Lights in view space, the ones lighting every pixel first
+		std::vector<LightData> lights;
+		uint32_t globalLights;
+		// Offset and count into lightIndices for every light cluster
+		std::vector<uint32_t> clusterRanges;
+		std::vector<uint32_t> lightIndices;
+		// The camera the frame was collected for
+		bool hasCamera;
+		glm::mat4 view;
+		glm::mat4 projection;
+		void clear();
+	};
+
+	void startRenderThread(RenderThread::BackendFactory factory);
 	void accumulateList();
-	void clearBuffers();
-	void renderScene();
-	void gBufferPass(glm::mat4 viewMatrix, glm::mat4 projectionMatrix);
-	void outlinePass(glm::mat4 viewMatrix, glm::mat4 projectionMatrix);
-	void lightingPass();
-	void uiPass();
-	void combineMasterGeometry(std::vector<RenderData>& data);
-	void combineOutlineGeometry(std::vector<RenderData>& data);
-	void makeLightsViewSpace(glm::mat4 viewMatrix);
+	void sortLists();
+	void recordFrame();
+	void recordBatches(const std::vector<RenderPacket>& packets);
+	bool getCameraMatrices(glm::mat4& view, glm::mat4& projection);
+	// Bring a renderable's proxy up to date. Returns false without touching it if nothing changed.
+	bool refreshProxy(Renderable* r);
+	void cullRange(const std::vector<Renderable*>& renderables, const Frustum& frustum, size_t begin, size_t end);
+	// Pick the detail level for an instance from how much of the screen its bounding sphere covers
+	Geometry* selectLOD(Geometry* geometry, const RenderProxy& proxy, const ExtractParams& params);
+	void extractRange(const std::vector<Renderable*>& renderables, const ExtractParams& params, size_t begin, size_t end, ExtractChunk& out);
+	void extractStatic(const ExtractParams& params);
+	static void worldBounds(Geometry* g, const glm::mat4& world, glm::vec3& center, float& radius, glm::vec3& extents);
+	void pushPacket(std::vector<RenderPacket>& packets, SortKey::Pass pass, unsigned int shader,
+		Model* model, uint32_t transformIndex, glm::vec4 color, float depth);
+	void collectLights(const std::vector<Light*>& lights, FrameData& frame);
+	static float lightRadius(const LightData& light);
+	int findTexture(std::string* path);
 	int getTexture(std::string* path);
-	int loadTexture(const std::string& path, bool scaleImage = true);
-	std::vector<GLfloat>* fetchSmoothNormals(Geometry* g);
-	std::vector<GLfloat>* calcSmoothNormals(Geometry* geometry);
-	Image* scaleImage(Image* input, int width, int height);
+	int loadTexture(const std::string& path);
+	int getMeshID(Geometry* geometry);
 	glm::vec4 convertColor(Color c);
 
+	// The window being drawn to, null when headless. Its size is read every frame to follow resizes.
 	Window* _window;
-	std::vector<RenderData>* _renderingList;
-	std::vector<RenderData>* _accumulatingList;
-	std::map<std::string, Shader> _shaders;
-	Shader* _shader;
+	float _aspectRatio;
+	FrameData _frame;
 
-	std::vector<RenderData>* _uiRenderingList;
-	std::vector<RenderData>* _uiAccumulatingList;
+	// Frames are recorded into one buffer while the render thread replays the other
+	RenderThread* _renderThread;
+	RenderCommandBuffer _buffers[2];
+	RenderCommandBuffer* _recording;
 
-	std::vector<RenderData>* _outlineRenderingList;
-	std::vector<RenderData>* _outlineAccumulatingList;
+	// Reused every frame to avoid reallocating
+	std::vector<RenderPacket> _sortScratch;
+	// Proxy bounding spheres and visibility, one entry per renderable
+	std::vector<float> _cullX;
+	std::vector<float> _cullY;
+	std::vector<float> _cullZ;
+	std::vector<float> _cullRadius;
+	std::vector<uint8_t> _visible;
+	std::vector<ExtractChunk> _extractChunks;
 
-	VertexArrayObject* _vao;
-	VertexBufferObject* _positionVBO;
-	VertexBufferObject* _normalVBO;
-	VertexBufferObject* _texCoordVBO;
-	ElementBufferObject* _ebo;
-
-	FrameBufferObject* _fbo;
-	FrameBufferObject* _outlineFBO;
-
-	UniformBufferObject* _ubo;
+	LightClusters* _lightClusters;
+	// View space bounds of this frame's clustered lights, reused between frames
+	std::vector<glm::vec4> _lightSpheres;
 	Camera* _camera;
 
-	FrameBufferObject* _resizeInFBO;
-	FrameBufferObject* _resizeOutFBO;
-	
-	GLTextureArray* _textures;
-	GLTexture* _albedoBuffer;
-	GLTexture* _normalBuffer;
-	GLTexture* _positionBuffer;
-	GLTexture* _outlineBuffer;
-
-	CombinedGeometry* _masterGeometry;
-	CombinedGeometry* _masterOutlineGeometry;
+	TextureAtlas* _textures;
 
 	Model* _screenQuad;
 	CpuProfiler profiler;
 
 	std::map<std::string, int> _texturePathToID;
-	
-	std::map<Geometry*, std::vector<GLfloat>*> _smoothNormalCache;
-
-	std::vector<Geometry*>* _staticGeometries;
-	std::vector<Image*>* _staticTextures;
 
-	std::vector<LightData>* _lightRenderingList;
-	std::vector<LightData>* _lightAccumulatingList;
+	// Renderables on static entities, merged into a few world space meshes
+	StaticBatcher _staticBatcher;
 };
\ No newline at end of file
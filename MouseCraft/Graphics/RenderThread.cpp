@@ -0,0 +1,64 @@
+#include "RenderThread.h"
+
+RenderThread::RenderThread(BackendFactory factory, bool threaded)
+	: _threaded(threaded), _backend(nullptr), _submitted(nullptr), _stopping(false) {
+	if (_threaded) {
+		_thread = std::thread(&RenderThread::run, this, factory);
+	}
+	else {
+		_backend = factory();
+	}
+}
+
+RenderThread::~RenderThread() {
+	if (_threaded) {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stopping = true;
+		}
+		_cv.notify_all();
+		_thread.join();
+	}
+	else {
+		delete _backend;
+	}
+}
+
+void RenderThread::submit(const RenderCommandBuffer* frame) {
+	if (!_threaded) {
+		_backend->execute(*frame);
+		_backend->present();
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_cv.wait(lock, [this] { return _submitted == nullptr; });
+	_submitted = frame;
+	lock.unlock();
+	_cv.notify_all();
+}
+
+void RenderThread::run(BackendFactory factory) {
+	// The backend takes the graphics context, so it lives and dies on this thread
+	_backend = factory();
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		// A submitted frame is still replayed when stopping
+		_cv.wait(lock, [this] { return _submitted != nullptr || _stopping; });
+		if (_submitted == nullptr) break;
+
+		const RenderCommandBuffer* frame = _submitted;
+		lock.unlock();
+		_backend->execute(*frame);
+		_backend->present();
+		lock.lock();
+
+		_submitted = nullptr;
+		_cv.notify_all();
+	}
+	lock.unlock();
+
+	delete _backend;
+	_backend = nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+#include "RenderBackend.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/// <summary>
+/// Runs a RenderBackend on its own thread and feeds it recorded frames.
+/// One frame is in flight at a time: while the backend replays frame N,
+/// the simulation records frame N+1 into another buffer.
+/// </summary>
+class RenderThread {
+public:
+	typedef std::function<RenderBackend*()> BackendFactory;
+
+	/// <summary>
+	/// Start the thread and create the backend on it
+	/// </summary>
+	/// <param name="factory">Makes the backend, called on the thread that will use it</param>
+	/// <param name="threaded">False to replay frames on the caller of submit instead</param>
+	RenderThread(BackendFactory factory, bool threaded = true);
+
+	/// <summary>
+	/// Finish the last submitted frame, then delete the backend on its thread and stop
+	/// </summary>
+	~RenderThread();
+
+	/// <summary>
+	/// Hand over a recorded frame for replay and presenting.
+	/// Waits until the previously submitted frame is done, so once this returns
+	/// that frame's buffer can be recorded into again.
+	/// </summary>
+	/// <param name="frame">The frame, which must not be touched until the next submit returns</param>
+	void submit(const RenderCommandBuffer* frame);
+private:
+	void run(BackendFactory factory);
+
+	bool _threaded;
+	RenderBackend* _backend;
+
+	std::thread _thread;
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	// The frame waiting for or being replayed, nullptr once it's done
+	const RenderCommandBuffer* _submitted;
+	bool _stopping;
+};
\ No newline at end of file
@@ -14,6 +14,7 @@ Model* Renderable::getModel() {
 
 void Renderable::setModel(Model& model) {
 	_model = &model;
+	_proxy.dirty = true;
 }
 
 Transform Renderable::getTransform() {
@@ -29,6 +30,11 @@ Color Renderable::getColor() {
 
 void Renderable::setColor(Color color) {
 	_color = color;
+	_proxy.dirty = true;
+}
+
+RenderProxy& Renderable::getProxy() {
+	return _proxy;
 }
 
 
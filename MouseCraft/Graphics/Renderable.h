@@ -3,6 +3,7 @@
 #include "../Core/Transform.h"
 #include "Model.h"
 #include "Color.h"
+#include "RenderProxy.h"
 #include "../Loading/PrefabLoader.h"
 #include "../json.hpp"
 using json = nlohmann::json;
@@ -15,9 +16,12 @@ public:
 	Transform getTransform();
 	Color getColor();
 	void setColor(Color color);
+	// The renderer's cached copy of this renderable
+	RenderProxy& getProxy();
 private:
 	Model* _model;
 	Color _color;
+	RenderProxy _proxy;
 
 	static Component* CreateFromJson(json json);
 	static PrefabRegistrar reg;
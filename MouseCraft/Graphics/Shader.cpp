@@ -2,6 +2,7 @@
 #include "../Loading/TextLoader.h"
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <vector>
 
 using std::cerr;
 using std::endl;
@@ -55,9 +56,35 @@ bool Shader::compile() {
 
 	glDeleteShader(vertShader);
 	glDeleteShader(fragShader);
+	cacheUniformLocations();
 	return true;
 }
 
+void Shader::cacheUniformLocations() {
+	_uniformLocations.clear();
+	GLint count = 0;
+	GLint maxLength = 0;
+	glGetProgramiv(_program, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+	std::vector<GLchar> nameBuffer(maxLength + 1);
+	for (GLint i = 0; i < count; i++) {
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(_program, i, maxLength + 1, &length, &size, &type, &nameBuffer[0]);
+		string name(&nameBuffer[0], length);
+		// Uniforms in blocks report -1 and are set through their buffer instead
+		GLint location = glGetUniformLocation(_program, name.c_str());
+		if (location < 0) continue;
+		_uniformLocations[name] = location;
+		// Arrays are reported as "name[0]", also allow looking them up by "name"
+		size_t bracket = name.find("[0]");
+		if (bracket != string::npos && bracket + 3 == name.size()) {
+			_uniformLocations[name.substr(0, bracket)] = location;
+		}
+	}
+}
+
 void Shader::printShaderError(GLuint shader) {
 	GLint logLen;
 	GLchar* logText;
@@ -88,44 +115,61 @@ GLuint Shader::getProgram() {
 	return _program;
 }
 
-void Shader::setUniformMatrix(string name, mat4 matrix) {
-	const char* cstr = name.c_str();
-	GLint pos = glGetUniformLocation(_program, cstr);
-	glUniformMatrix4fv(pos, 1, GL_FALSE, value_ptr(matrix));
+GLint Shader::getUniformLocation(const string& name) {
+	auto it = _uniformLocations.find(name);
+	return it != _uniformLocations.end() ? it->second : -1;
+}
+
+void Shader::setUniformMatrix(const string& name, const mat4& matrix) {
+	setUniformMatrix(getUniformLocation(name), matrix);
+}
+
+void Shader::setUniformVec3(const string& name, const vec3& vector) {
+	setUniformVec3(getUniformLocation(name), vector);
+}
+
+void Shader::setUniformVec4(const string& name, const vec4& vector) {
+	setUniformVec4(getUniformLocation(name), vector);
+}
+
+void Shader::setUniformTexture(const string& name, GLuint index) {
+	setUniformTexture(getUniformLocation(name), index);
+}
+
+void Shader::setUniformInt(const string& name, GLint value) {
+	setUniformInt(getUniformLocation(name), value);
+}
+
+void Shader::setUniformFloat(const string& name, GLfloat value) {
+	setUniformFloat(getUniformLocation(name), value);
+}
+
+void Shader::setUniformMatrix(GLint location, const mat4& matrix) {
+	glUniformMatrix4fv(location, 1, GL_FALSE, value_ptr(matrix));
 }
 
-void Shader::setUniformVec3(string name, vec3 vector) {
-	const char* cstr = name.c_str();
-	GLint pos = glGetUniformLocation(_program, cstr);
-	glUniform3f(pos, vector.r, vector.g, vector.b);
+void Shader::setUniformVec3(GLint location, const vec3& vector) {
+	glUniform3f(location, vector.r, vector.g, vector.b);
 }
 
-void Shader::setUniformVec4(string name, vec4 vector) {
-	const char* cstr = name.c_str();
-	GLint pos = glGetUniformLocation(_program, cstr);
-	glUniform4f(pos, vector.r, vector.g, vector.b, vector.a);
+void Shader::setUniformVec4(GLint location, const vec4& vector) {
+	glUniform4f(location, vector.r, vector.g, vector.b, vector.a);
 }
 
-void Shader::setUniformTexture(string name, GLuint index) {
-	const char* cstr = name.c_str();
-	GLint pos = glGetUniformLocation(_program, cstr);
-	glUniform1i(pos, index);
+void Shader::setUniformTexture(GLint location, GLuint index) {
+	glUniform1i(location, index);
 }
 
-void Shader::setUniformInt(string name, GLint value) {
-	const char* cstr = name.c_str();
-	GLint pos = glGetUniformLocation(_program, cstr);
-	glUniform1i(pos, value);
+void Shader::setUniformInt(GLint location, GLint value) {
+	glUniform1i(location, value);
 }
 
-void Shader::setUniformFloat(string name, GLfloat value) {
-	const char* cstr = name.c_str();
-	GLint pos = glGetUniformLocation(_program, cstr);
-	glUniform1f(pos, value);
+void Shader::setUniformFloat(GLint location, GLfloat value) {
+	glUniform1f(location, value);
 }
 
-void Shader::setBindingPoint(string name, GLint value) {
-	const char* cstr = name.c_str();
-	GLuint index = glGetUniformBlockIndex(_program, cstr);
+void Shader::setBindingPoint(const string& name, GLint value) {
+	GLuint index = glGetUniformBlockIndex(_program, name.c_str());
+	if (index == GL_INVALID_INDEX) return;
 	glUniformBlockBinding(_program, index, value);
 }
\ No newline at end of file
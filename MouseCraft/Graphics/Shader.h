@@ -2,6 +2,7 @@
 #include "../GL/glad.h"
 #include "glm/glm.hpp"
 #include <string>
+#include <map>
 #include "GLTexture.h"
 
 class Shader {
@@ -10,18 +11,30 @@ public:
 	Shader(std::string name, std::string vertSrc, std::string fragSrc);
 	bool compile();
 	GLuint getProgram();
-	void setUniformMatrix(std::string name, glm::mat4 matrix);
-	void setUniformVec3(std::string name, glm::vec3 vector);
-	void setUniformVec4(std::string name, glm::vec4 vector);
-	void setUniformTexture(std::string name, GLuint index);
-	void setUniformInt(std::string name, GLint value);
-	void setUniformFloat(std::string name, GLfloat value);
-	void setBindingPoint(std::string name, GLint value);
+	// Locations are looked up once when the program links.
+	// Returns -1 if the uniform isn't active, which the setters ignore.
+	GLint getUniformLocation(const std::string& name);
+	void setUniformMatrix(const std::string& name, const glm::mat4& matrix);
+	void setUniformVec3(const std::string& name, const glm::vec3& vector);
+	void setUniformVec4(const std::string& name, const glm::vec4& vector);
+	void setUniformTexture(const std::string& name, GLuint index);
+	void setUniformInt(const std::string& name, GLint value);
+	void setUniformFloat(const std::string& name, GLfloat value);
+	// Setters by location, for uniforms set every draw
+	void setUniformMatrix(GLint location, const glm::mat4& matrix);
+	void setUniformVec3(GLint location, const glm::vec3& vector);
+	void setUniformVec4(GLint location, const glm::vec4& vector);
+	void setUniformTexture(GLint location, GLuint index);
+	void setUniformInt(GLint location, GLint value);
+	void setUniformFloat(GLint location, GLfloat value);
+	void setBindingPoint(const std::string& name, GLint value);
 private:
 	void printShaderError(GLuint shader);
 	void printProgramError(GLuint program);
+	void cacheUniformLocations();
 	std::string vertSrc;
 	std::string fragSrc;
 	std::string _name;
 	GLuint _program;
+	std::map<std::string, GLint> _uniformLocations;
 };
\ No newline at end of file
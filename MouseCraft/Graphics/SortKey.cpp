@@ -0,0 +1,68 @@
+#include "SortKey.h"
+#include "TextureAtlas.h"
+#include <cstring>
+#include <algorithm>
+
+using std::vector;
+
+// Texture IDs past the field would share a key and batch with the wrong texture
+static_assert(TextureAtlas::MAX_TEXTURES <= 0x400, "Texture IDs must fit the sort key's 10 bit texture field");
+
+uint64_t SortKey::opaque(Pass pass, unsigned int shader, unsigned int texture, unsigned int geometry, float depth) {
+	float clamped = std::min(std::max(depth, 0.0f), 1.0f);
+	uint64_t quantized = (uint64_t)(clamped * 0xFFFFFF);
+	return ((uint64_t)pass << 62)
+		| ((uint64_t)(shader & 0x3F) << 56)
+		| ((uint64_t)(texture & 0x3FF) << 46)
+		| ((uint64_t)(geometry & 0x3FFFFF) << 24)
+		| quantized;
+}
+
+uint64_t SortKey::transparent(Pass pass, unsigned int shader, unsigned int texture, unsigned int geometry, float depth) {
+	// Invert so the furthest draw has the smallest key
+	uint64_t quantized = ~(orderedBits(depth) >> 8) & 0xFFFFFF;
+	return ((uint64_t)pass << 62)
+		| ((uint64_t)(shader & 0x3F) << 56)
+		| (quantized << 32)
+		| ((uint64_t)(texture & 0x3FF) << 22)
+		| (uint64_t)(geometry & 0x3FFFFF);
+}
+
+void SortKey::radixSort(vector<RenderPacket>& packets, vector<RenderPacket>& scratch) {
+	size_t count = packets.size();
+	if (count < 2) return;
+	scratch.resize(count);
+
+	vector<RenderPacket>* src = &packets;
+	vector<RenderPacket>* dst = &scratch;
+	size_t histogram[256];
+	for (int shift = 0; shift < 64; shift += 8) {
+		memset(histogram, 0, sizeof(histogram));
+		for (const RenderPacket& p : *src) {
+			histogram[(p.sortKey >> shift) & 0xFF]++;
+		}
+		// Every key shares this byte, the order won't change
+		if (histogram[((*src)[0].sortKey >> shift) & 0xFF] == count) continue;
+
+		size_t offset = 0;
+		for (size_t& bucket : histogram) {
+			size_t size = bucket;
+			bucket = offset;
+			offset += size;
+		}
+		for (const RenderPacket& p : *src) {
+			(*dst)[histogram[(p.sortKey >> shift) & 0xFF]++] = p;
+		}
+		std::swap(src, dst);
+	}
+	if (src != &packets) {
+		packets.swap(scratch);
+	}
+}
+
+uint32_t SortKey::orderedBits(float value) {
+	// Flip floats so their bits compare in the same order as their values
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include "RenderPacket.h"
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// Builds and sorts the 64 bit keys that order render packets.
+/// Opaque layout:      pass (2) | shader (6) | texture (10) | geometry (22) | depth (24)
+/// Transparent layout: pass (2) | shader (6) | depth (24)   | texture (10)  | geometry (22)
+/// Opaque draws group by state and go front to back inside a group,
+/// transparent draws go back to front first and only group by state on ties.
+/// </summary>
+class SortKey {
+public:
+	enum Pass {
+		GBUFFER = 0,
+		OUTLINE = 1,
+		UI = 2
+	};
+
+	/// <summary>
+	/// The bits of an opaque key that select state, draws with equal state bits can be batched
+	/// </summary>
+	static const uint64_t STATE_MASK = ~0xFFFFFFull;
+
+	/// <summary>
+	/// Make a key for an opaque draw
+	/// </summary>
+	/// <param name="pass">The pass the draw belongs to</param>
+	/// <param name="shader">The shader program</param>
+	/// <param name="texture">The texture's region ID in the atlas</param>
+	/// <param name="geometry">The mesh ID in the arena</param>
+	/// <param name="depth">Distance from the camera normalized to [0, 1]</param>
+	static uint64_t opaque(Pass pass, unsigned int shader, unsigned int texture, unsigned int geometry, float depth);
+
+	/// <summary>
+	/// Make a key for a blended draw, larger depths are drawn first
+	/// </summary>
+	/// <param name="pass">The pass the draw belongs to</param>
+	/// <param name="shader">The shader program</param>
+	/// <param name="texture">The texture's region ID in the atlas</param>
+	/// <param name="geometry">The mesh ID in the arena, 0 if the geometry is streamed</param>
+	/// <param name="depth">Any depth value, only its ordering matters</param>
+	static uint64_t transparent(Pass pass, unsigned int shader, unsigned int texture, unsigned int geometry, float depth);
+
+	/// <summary>
+	/// Stable LSD radix sort of packets by key, 8 bits per pass.
+	/// Passes where every key has the same byte are skipped.
+	/// </summary>
+	/// <param name="packets">The packets to sort</param>
+	/// <param name="scratch">Reused storage the same size as packets</param>
+	static void radixSort(std::vector<RenderPacket>& packets, std::vector<RenderPacket>& scratch);
+private:
+	static uint32_t orderedBits(float value);
+};
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "StaticBatcher.h"
+#include "Renderable.h"
+#include "../Core/Entity.h"
+#include <algorithm>
+
+// Batches stay small enough for 16 bit indices
+#define MAX_BATCH_VERTICES 65536
+
+using std::vector;
+using glm::vec3;
+using glm::vec4;
+using glm::mat3;
+using glm::mat4;
+
+namespace {
+	// A batch's arrays while members are appended, handed to its geometry once at the end
+	struct BatchData {
+		vector<GLfloat> positions;
+		vector<GLfloat> normals;
+		vector<GLfloat> smoothNormals;
+		vector<GLfloat> texCoords;
+		vector<GLuint> indices;
+	};
+
+	void pushNormal(const mat3& normalMatrix, const vector<GLfloat>& src, size_t i, vector<GLfloat>& dst) {
+		vec3 n = normalMatrix * vec3(src[i * 3], src[i * 3 + 1], src[i * 3 + 2]);
+		float length = glm::length(n);
+		if (length > 0.0f) n /= length;
+		dst.push_back(n.x);
+		dst.push_back(n.y);
+		dst.push_back(n.z);
+	}
+
+	void append(Geometry* source, const mat4& world, BatchData& batch) {
+		const vector<GLfloat>& positions = source->getVertexData();
+		const vector<GLfloat>& normals = source->getNormalData();
+		const vector<GLfloat>& smoothNormals = source->getSmoothNormalData();
+		const vector<GLfloat>& texCoords = source->getTexCoordData();
+		size_t count = positions.size() / 3;
+		GLuint base = batch.positions.size() / 3;
+		// Normals go through the inverse transpose so non uniform scales keep them perpendicular
+		mat3 normalMatrix = glm::transpose(glm::inverse(mat3(world)));
+
+		for (size_t i = 0; i < count; i++) {
+			vec3 p = vec3(world * vec4(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2], 1.0f));
+			batch.positions.push_back(p.x);
+			batch.positions.push_back(p.y);
+			batch.positions.push_back(p.z);
+			if (normals.size() == positions.size()) {
+				pushNormal(normalMatrix, normals, i, batch.normals);
+			}
+			else {
+				batch.normals.insert(batch.normals.end(), { 0.0f, 1.0f, 0.0f });
+			}
+			// A batch has smooth normals for every vertex or none, so members without them use their normals
+			if (smoothNormals.size() == positions.size()) {
+				pushNormal(normalMatrix, smoothNormals, i, batch.smoothNormals);
+			}
+			else {
+				batch.smoothNormals.insert(batch.smoothNormals.end(), batch.normals.end() - 3, batch.normals.end());
+			}
+			if (texCoords.size() == count * 2) {
+				batch.texCoords.push_back(texCoords[i * 2]);
+				batch.texCoords.push_back(texCoords[i * 2 + 1]);
+			}
+			else {
+				batch.texCoords.insert(batch.texCoords.end(), { 0.0f, 0.0f });
+			}
+		}
+		for (GLuint index : source->getIndices()) {
+			batch.indices.push_back(base + index);
+		}
+	}
+}
+
+bool StaticBatcher::isBatched(Renderable* renderable) {
+	Entity* e = renderable->GetEntity();
+	return e != nullptr && e->GetStatic();
+}
+
+bool StaticBatcher::update(const vector<Renderable*>& renderables) {
+	_scratch.clear();
+	for (Renderable* r : renderables) {
+		if (!r->GetActive() || !isBatched(r)) continue;
+		Model* m = r->getModel();
+		Color c = r->getColor();
+		_scratch.push_back(Member{ r->GetID(), r, m->getGeometry(), m->getTexture(), vec4(c.getRed(), c.getGreen(), c.getBlue(), c.getAlpha()) });
+	}
+	// Nearly every frame nothing changed, and the list is in component order both times
+	if (_scratch == _members) return false;
+
+	_members.swap(_scratch);
+	rebuild();
+	return true;
+}
+
+void StaticBatcher::rebuild() {
+	_batches.clear();
+
+	// Group by material, and within a material sweep across the world so each batch's bounds stay tight
+	vector<size_t> order(_members.size());
+	for (size_t i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+	auto textureName = [](std::string* texture) { return texture != nullptr ? *texture : std::string(); };
+	std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		const Member& ma = _members[a];
+		const Member& mb = _members[b];
+		std::string ta = textureName(ma.texture), tb = textureName(mb.texture);
+		if (ta != tb) return ta < tb;
+		for (int i = 0; i < 4; i++) {
+			if (ma.color[i] != mb.color[i]) return ma.color[i] < mb.color[i];
+		}
+		const mat4& wa = ma.renderable->GetEntity()->transform.getWorldTransformation();
+		const mat4& wb = mb.renderable->GetEntity()->transform.getWorldTransformation();
+		if (wa[3].x != wb[3].x) return wa[3].x < wb[3].x;
+		return wa[3].z < wb[3].z;
+	});
+
+	vector<BatchData> data;
+	const Member* previous = nullptr;
+	for (size_t i : order) {
+		const Member& member = _members[i];
+		size_t vertices = member.geometry->getVertexData().size() / 3;
+		bool sameMaterial = previous != nullptr && textureName(previous->texture) == textureName(member.texture) && previous->color == member.color;
+		if (data.empty() || !sameMaterial || data.back().positions.size() / 3 + vertices > MAX_BATCH_VERTICES) {
+			_batches.emplace_back();
+			_batches.back().texture = member.texture;
+			_batches.back().color = member.color;
+			data.emplace_back();
+		}
+		append(member.geometry, member.renderable->GetEntity()->transform.getWorldTransformation(), data.back());
+		previous = &member;
+	}
+
+	for (size_t i = 0; i < _batches.size(); i++) {
+		Geometry* g = new Geometry();
+		g->setVertexData(data[i].positions);
+		g->setNormalData(data[i].normals);
+		g->setSmoothNormalData(data[i].smoothNormals);
+		g->setTexCoordData(data[i].texCoords);
+		g->setIndices(data[i].indices);
+		g->pack();
+		_batches[i].geometry.reset(g);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+#include "Geometry.h"
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Renderable;
+
+/// <summary>
+/// Static renderables that share a texture and color, merged into one world space mesh
+/// </summary>
+struct StaticBatch {
+	/// <summary>
+	/// The merged mesh, already moved to world space so it's drawn with an identity transform
+	/// </summary>
+	std::unique_ptr<Geometry> geometry;
+
+	/// <summary>
+	/// The texture every member uses, null for the default texture
+	/// </summary>
+	std::string* texture;
+
+	/// <summary>
+	/// The tint every member uses
+	/// </summary>
+	glm::vec4 color;
+};
+
+/// <summary>
+/// Merges the renderables of static entities into a few large meshes so they cost a handful of draws.
+/// Static entities never move, so their vertices are transformed once when the set of static
+/// renderables changes instead of being drawn as separate instances every frame.
+/// </summary>
+class StaticBatcher {
+public:
+	/// <summary>
+	/// Rebuild the batches if any renderable became static, stopped being static,
+	/// was disabled, or changed its model or color since the last call
+	/// </summary>
+	/// <param name="renderables">Every renderable in the scene</param>
+	/// <returns>True if the batches were rebuilt</returns>
+	bool update(const std::vector<Renderable*>& renderables);
+
+	/// <summary>
+	/// Get the merged meshes to draw in place of the static renderables
+	/// </summary>
+	const std::vector<StaticBatch>& getBatches() { return _batches; }
+
+	/// <summary>
+	/// Check if a renderable is drawn by a batch rather than on its own
+	/// </summary>
+	/// <param name="renderable">Any renderable in the scene</param>
+	/// <returns>True if its entity is static</returns>
+	static bool isBatched(Renderable* renderable);
+private:
+	/// <summary>
+	/// What a batched renderable looked like when the batches were built
+	/// </summary>
+	struct Member {
+		unsigned int id;
+		Renderable* renderable;
+		Geometry* geometry;
+		std::string* texture;
+		glm::vec4 color;
+
+		bool operator==(const Member& other) const {
+			return id == other.id && geometry == other.geometry && texture == other.texture && color == other.color;
+		}
+	};
+
+	void rebuild();
+
+	std::vector<Member> _members;
+	// Filled every update and compared against _members, kept to avoid reallocating
+	std::vector<Member> _scratch;
+	std::vector<StaticBatch> _batches;
+};
\ No newline at end of file
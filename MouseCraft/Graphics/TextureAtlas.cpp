@@ -0,0 +1,43 @@
+#include "TextureAtlas.h"
+
+TextureAtlas::TextureAtlas(int pageSize, int minCellSize)
+	: _pageSize(pageSize), _minCellSize(minCellSize), _usedLayers(0) {
+}
+
+int TextureAtlas::cellSize(int width, int height) const {
+	return TextureFilter::fitPowerOfTwo(width, height, _minCellSize, _pageSize);
+}
+
+int TextureAtlas::add(int size, int levels, int& layer, int& x, int& y) {
+	int cellsPerRow = size > 0 ? _pageSize / size : 0;
+	int cellsPerLayer = cellsPerRow * cellsPerRow;
+	if (cellsPerLayer == 0 || (int)_regions.size() >= MAX_TEXTURES) return -1;
+
+	// Open a new layer for this size once the current one is full, replacing the full bucket
+	Bucket& bucket = _buckets[size];
+	if (bucket.layer < 0 || bucket.nextCell >= cellsPerLayer) {
+		bucket.layer = _usedLayers++;
+		bucket.nextCell = 0;
+	}
+	int cell = bucket.nextCell++;
+
+	layer = bucket.layer;
+	x = (cell % cellsPerRow) * size;
+	y = (cell / cellsPerRow) * size;
+
+	TextureRegion region;
+	float scale = (float)size / _pageSize;
+	region.rect = glm::vec4((float)x / _pageSize, (float)y / _pageSize, scale, scale);
+	region.layer = (float)layer;
+	region.maxLod = (float)(levels - 1);
+	_regions.push_back(region);
+	return _regions.size() - 1;
+}
+
+const TextureRegion& TextureAtlas::getRegion(int id) const {
+	return _regions[id];
+}
+
+int TextureAtlas::getLayerCount() const {
+	return _usedLayers;
+}
\ No newline at end of file
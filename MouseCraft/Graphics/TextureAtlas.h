@@ -0,0 +1,76 @@
+#pragma once
+#include "TextureFilter.h"
+#include <glm/glm.hpp>
+#include <map>
+#include <vector>
+
+/// <summary>
+/// Where a texture lives inside the atlas
+/// </summary>
+struct TextureRegion {
+	// Offset in xy and size in zw, as a fraction of the page
+	glm::vec4 rect;
+	float layer;
+	// The smallest mip level that only holds this texture
+	float maxLod;
+};
+
+/// <summary>
+/// Packs textures into the layers of one texture array.
+/// Every layer is split into square cells of one power of two size, so small textures
+/// share a layer instead of each taking a full page. Layers are added as they fill up.
+/// This only decides placement, the backend copies the texels in.
+/// </summary>
+class TextureAtlas {
+public:
+	/// <summary>
+	/// The most textures the atlas hands out IDs for, sort keys hold the ID in 10 bits
+	/// </summary>
+	static const int MAX_TEXTURES = 1024;
+
+	/// <summary>
+	/// Create an empty atlas
+	/// </summary>
+	/// <param name="pageSize">The width and height of every layer and the largest cell</param>
+	/// <param name="minCellSize">The smallest cell, textures below this are scaled up</param>
+	TextureAtlas(int pageSize, int minCellSize);
+
+	/// <summary>
+	/// Get the cell size an image of the given size is stored at
+	/// </summary>
+	int cellSize(int width, int height) const;
+
+	/// <summary>
+	/// Reserve a cell for a square mip chain made for cellSize()
+	/// </summary>
+	/// <param name="size">The width and height of the largest level</param>
+	/// <param name="levels">The number of levels in the chain</param>
+	/// <param name="layer">Receives the layer of the cell</param>
+	/// <param name="x">Receives the left of the cell in texels</param>
+	/// <param name="y">Receives the bottom of the cell in texels</param>
+	/// <returns>The id of the texture, or -1 if the size doesn't fit in a page or the atlas holds MAX_TEXTURES</returns>
+	int add(int size, int levels, int& layer, int& x, int& y);
+
+	/// <summary>
+	/// Get where a texture was placed
+	/// </summary>
+	const TextureRegion& getRegion(int id) const;
+
+	/// <summary>
+	/// Get the number of layers with cells in use
+	/// </summary>
+	int getLayerCount() const;
+private:
+	// The layer currently being filled for one cell size
+	struct Bucket {
+		Bucket() : layer(-1), nextCell(0) {}
+		int layer;
+		int nextCell;
+	};
+
+	int _pageSize;
+	int _minCellSize;
+	int _usedLayers;
+	std::map<int, Bucket> _buckets;
+	std::vector<TextureRegion> _regions;
+};
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include "TextureFilter.h"
+#include <xmmintrin.h>
+#include <algorithm>
+#include <cmath>
+
+using std::vector;
+
+// Kaiser window shape and the filter's half width in destination texels
+#define KAISER_ALPHA 4.0f
+#define KAISER_RADIUS 3.0f
+#define PI 3.14159265358979f
+
+namespace {
+	// Precise enough for 8 bit output, sRGB to linear for every byte value
+	const float* srgbToLinearTable() {
+		static float table[256];
+		static bool built = false;
+		if (!built) {
+			for (int i = 0; i < 256; i++) {
+				float c = i / 255.0f;
+				table[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+			}
+			built = true;
+		}
+		return table;
+	}
+
+	// Linear to sRGB byte, indexed by the linear value scaled to 0-4095
+	const unsigned char* linearToSRGBTable() {
+		static unsigned char table[4096];
+		static bool built = false;
+		if (!built) {
+			for (int i = 0; i < 4096; i++) {
+				float c = i / 4095.0f;
+				float s = c <= 0.0031308f ? c * 12.92f : 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
+				table[i] = (unsigned char)(s * 255.0f + 0.5f);
+			}
+			built = true;
+		}
+		return table;
+	}
+
+	// Source pixels and weights that make up one destination pixel along an axis
+	struct Contributors {
+		int first;
+		vector<float> weights;
+	};
+}
+
+vector<MipLevel> TextureFilter::buildMipChain(Image& image, int size, MipFilter filter) {
+	vector<MipLevel> levels;
+	FloatImage level = toLinear(image);
+	if (level.width != size || level.height != size) {
+		level = resample(level, size, size);
+	}
+	levels.push_back(toSRGB(level));
+
+	while (level.width > 1 || level.height > 1) {
+		if (filter == BOX) {
+			level = boxHalve(level);
+		}
+		else {
+			level = resample(level, std::max(level.width / 2, 1), std::max(level.height / 2, 1));
+		}
+		levels.push_back(toSRGB(level));
+	}
+	return levels;
+}
+
+int TextureFilter::fitPowerOfTwo(int width, int height, int minSize, int maxSize) {
+	int size = minSize;
+	while (size < width || size < height) {
+		size *= 2;
+	}
+	return std::min(size, maxSize);
+}
+
+TextureFilter::FloatImage TextureFilter::toLinear(Image& image) {
+	const float* table = srgbToLinearTable();
+	FloatImage result;
+	result.width = image.getWidth();
+	result.height = image.getHeight();
+	result.pixels.resize(result.width * result.height * 4);
+
+	// Missing channels read like GL would upload them, zero color and opaque alpha
+	int channels = image.getChannels();
+	const unsigned char* data = image.getData();
+	size_t count = (size_t)result.width * result.height;
+	for (size_t i = 0; i < count; i++) {
+		const unsigned char* src = data + i * channels;
+		float* dst = &result.pixels[i * 4];
+		dst[0] = table[src[0]];
+		dst[1] = channels > 1 ? table[src[1]] : 0.0f;
+		dst[2] = channels > 2 ? table[src[2]] : 0.0f;
+		dst[3] = channels > 3 ? src[3] / 255.0f : 1.0f;
+	}
+	return result;
+}
+
+MipLevel TextureFilter::toSRGB(const FloatImage& image) {
+	const unsigned char* table = linearToSRGBTable();
+	MipLevel result;
+	result.width = image.width;
+	result.height = image.height;
+	result.pixels.resize(image.pixels.size());
+
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(4095.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	size_t count = (size_t)image.width * image.height;
+	for (size_t i = 0; i < count; i++) {
+		// Sharpening filters overshoot, so clamp before the lookup
+		__m128 c = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&image.pixels[i * 4]), zero), one);
+		float index[4];
+		_mm_storeu_ps(index, _mm_add_ps(_mm_mul_ps(c, scale), half));
+		result.pixels[i * 4] = table[(int)index[0]];
+		result.pixels[i * 4 + 1] = table[(int)index[1]];
+		result.pixels[i * 4 + 2] = table[(int)index[2]];
+		// Alpha is stored linearly
+		result.pixels[i * 4 + 3] = (unsigned char)(index[3] / 4095.0f * 255.0f + 0.5f);
+	}
+	return result;
+}
+
+TextureFilter::FloatImage TextureFilter::resample(const FloatImage& src, int width, int height) {
+	// Weights for each destination column or row. When shrinking the filter widens with the scale.
+	auto contributors = [](int srcSize, int dstSize) {
+		vector<Contributors> result(dstSize);
+		float scale = (float)srcSize / dstSize;
+		float stretch = std::max(scale, 1.0f);
+		float radius = KAISER_RADIUS * stretch;
+		for (int i = 0; i < dstSize; i++) {
+			float center = (i + 0.5f) * scale - 0.5f;
+			int first = (int)floorf(center - radius);
+			int last = (int)ceilf(center + radius);
+			float total = 0.0f;
+			result[i].first = first;
+			for (int s = first; s <= last; s++) {
+				float x = (s - center) / stretch;
+				float w = sinc(x) * kaiser(x / KAISER_RADIUS);
+				result[i].weights.push_back(w);
+				total += w;
+			}
+			for (float& w : result[i].weights) {
+				w /= total;
+			}
+		}
+		return result;
+	};
+
+	vector<Contributors> columns = contributors(src.width, width);
+	vector<Contributors> rows = contributors(src.height, height);
+
+	// Horizontal pass into a width x src.height image, clamping at the edges
+	FloatImage wide;
+	wide.width = width;
+	wide.height = src.height;
+	wide.pixels.resize(width * src.height * 4);
+	for (int y = 0; y < src.height; y++) {
+		const float* srcRow = &src.pixels[y * src.width * 4];
+		float* dstRow = &wide.pixels[y * width * 4];
+		for (int x = 0; x < width; x++) {
+			const Contributors& c = columns[x];
+			__m128 sum = _mm_setzero_ps();
+			for (size_t i = 0; i < c.weights.size(); i++) {
+				int sx = std::min(std::max(c.first + (int)i, 0), src.width - 1);
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(srcRow + sx * 4), _mm_set1_ps(c.weights[i])));
+			}
+			_mm_storeu_ps(dstRow + x * 4, sum);
+		}
+	}
+
+	// Vertical pass, whole rows at a time
+	FloatImage result;
+	result.width = width;
+	result.height = height;
+	result.pixels.resize(width * height * 4);
+	for (int y = 0; y < height; y++) {
+		const Contributors& c = rows[y];
+		float* dstRow = &result.pixels[y * width * 4];
+		for (size_t i = 0; i < c.weights.size(); i++) {
+			int sy = std::min(std::max(c.first + (int)i, 0), src.height - 1);
+			const float* srcRow = &wide.pixels[sy * width * 4];
+			__m128 w = _mm_set1_ps(c.weights[i]);
+			for (int x = 0; x < width; x++) {
+				__m128 sum = _mm_loadu_ps(dstRow + x * 4);
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(srcRow + x * 4), w));
+				_mm_storeu_ps(dstRow + x * 4, sum);
+			}
+		}
+	}
+	return result;
+}
+
+TextureFilter::FloatImage TextureFilter::boxHalve(const FloatImage& src) {
+	FloatImage result;
+	result.width = std::max(src.width / 2, 1);
+	result.height = std::max(src.height / 2, 1);
+	result.pixels.resize(result.width * result.height * 4);
+
+	const __m128 quarter = _mm_set1_ps(0.25f);
+	for (int y = 0; y < result.height; y++) {
+		int y0 = std::min(y * 2, src.height - 1);
+		int y1 = std::min(y * 2 + 1, src.height - 1);
+		for (int x = 0; x < result.width; x++) {
+			int x0 = std::min(x * 2, src.width - 1);
+			int x1 = std::min(x * 2 + 1, src.width - 1);
+			__m128 sum = _mm_add_ps(
+				_mm_add_ps(_mm_loadu_ps(&src.pixels[(y0 * src.width + x0) * 4]), _mm_loadu_ps(&src.pixels[(y0 * src.width + x1) * 4])),
+				_mm_add_ps(_mm_loadu_ps(&src.pixels[(y1 * src.width + x0) * 4]), _mm_loadu_ps(&src.pixels[(y1 * src.width + x1) * 4]))
+			);
+			_mm_storeu_ps(&result.pixels[(y * result.width + x) * 4], _mm_mul_ps(sum, quarter));
+		}
+	}
+	return result;
+}
+
+float TextureFilter::kaiser(float x) {
+	if (fabsf(x) > 1.0f) return 0.0f;
+
+	// Zeroth order modified Bessel function by its power series
+	auto bessel = [](float v) {
+		float sum = 1.0f;
+		float term = 1.0f;
+		for (int k = 1; k < 16; k++) {
+			term *= (v / (2.0f * k)) * (v / (2.0f * k));
+			sum += term;
+		}
+		return sum;
+	};
+	return bessel(KAISER_ALPHA * sqrtf(1.0f - x * x)) / bessel(KAISER_ALPHA);
+}
+
+float TextureFilter::sinc(float x) {
+	if (fabsf(x) < 1e-5f) return 1.0f;
+	return sinf(PI * x) / (PI * x);
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+#include "Image.h"
+#include <vector>
+
+/// <summary>
+/// One level of a mip chain as 8 bit sRGB RGBA texels
+/// </summary>
+struct MipLevel {
+	int width;
+	int height;
+	std::vector<unsigned char> pixels;
+};
+
+/// <summary>
+/// Resizes images and builds mip chains on the CPU.
+/// Filtering happens on linear RGBA floats, one pixel per SSE register.
+/// </summary>
+class TextureFilter {
+public:
+	enum MipFilter {
+		// 2x2 average, fast but soft
+		BOX,
+		// Kaiser windowed sinc, keeps detail in the smaller levels
+		KAISER
+	};
+
+	/// <summary>
+	/// Resample an image to a square texture and build every level down to 1x1
+	/// </summary>
+	/// <param name="image">The source image, any channel count</param>
+	/// <param name="size">The width and height of the first level, a power of two</param>
+	/// <param name="filter">The filter used for each smaller level</param>
+	/// <returns>The levels, largest first</returns>
+	static std::vector<MipLevel> buildMipChain(Image& image, int size, MipFilter filter = KAISER);
+
+	/// <summary>
+	/// Get the smallest power of two that holds the image, clamped to the given range
+	/// </summary>
+	static int fitPowerOfTwo(int width, int height, int minSize, int maxSize);
+private:
+	// Linear RGBA floats, 4 per pixel
+	struct FloatImage {
+		int width;
+		int height;
+		std::vector<float> pixels;
+	};
+
+	static FloatImage toLinear(Image& image);
+	static MipLevel toSRGB(const FloatImage& image);
+	static FloatImage resample(const FloatImage& src, int width, int height);
+	static FloatImage boxHalve(const FloatImage& src);
+	static float kaiser(float x);
+	static float sinc(float x);
+};
\ No newline at end of file
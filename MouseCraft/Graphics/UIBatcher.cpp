@@ -0,0 +1,31 @@
+#include "UIBatcher.h"
+#include <cstddef>
+
+UIBatcher::UIBatcher() {
+	_vao = new VertexArrayObject();
+	_vbo = new VertexBufferObject(4);
+	_ebo = new ElementBufferObject();
+
+	_vao->setAttribute(0, *_vbo, 4, sizeof(UIVertex), offsetof(UIVertex, position));
+	_vao->setAttribute(1, *_vbo, 4, sizeof(UIVertex), offsetof(UIVertex, color));
+	_vao->setAttribute(2, *_vbo, 2, sizeof(UIVertex), offsetof(UIVertex, texCoord));
+	_vao->setAttribute(3, *_vbo, 1, sizeof(UIVertex), offsetof(UIVertex, layer));
+	_vao->setAttribute(4, *_vbo, 4, sizeof(UIVertex), offsetof(UIVertex, textureRect));
+	_vao->setAttribute(5, *_vbo, 1, sizeof(UIVertex), offsetof(UIVertex, maxLod));
+	_vao->setElementBuffer(*_ebo);
+}
+
+UIBatcher::~UIBatcher() {
+	delete _vao;
+	delete _vbo;
+	delete _ebo;
+}
+
+int UIBatcher::draw(const std::vector<UIVertex>& vertices, const std::vector<GLuint>& indices) {
+	if (indices.empty()) return 0;
+	_vao->bind();
+	_vbo->stream(&vertices[0], vertices.size() * sizeof(UIVertex));
+	_ebo->buffer(indices);
+	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, (void*)0);
+	return 1;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include "../GL/glad.h"
+#include "RenderCommands.h"
+#include "BufferObjects/VertexArrayObject.h"
+#include "BufferObjects/VertexBufferObject.h"
+#include "BufferObjects/ElementBufferObject.h"
+#include <vector>
+
+/// <summary>
+/// Draws a frame's UI quads and glyphs from one streamed vertex buffer.
+/// Vertices arrive in clip space carrying their own color and texture region,
+/// so the whole UI draws in submission order with a single call.
+/// </summary>
+class UIBatcher {
+public:
+	UIBatcher();
+	~UIBatcher();
+
+	/// <summary>
+	/// Upload the vertices and draw them. The UI shader must be bound.
+	/// </summary>
+	/// <param name="vertices">The frame's UI vertices</param>
+	/// <param name="indices">Triangles indexing into vertices</param>
+	/// <returns>The number of draw calls issued</returns>
+	int draw(const std::vector<UIVertex>& vertices, const std::vector<GLuint>& indices);
+private:
+	VertexArrayObject* _vao;
+	VertexBufferObject* _vbo;
+	ElementBufferObject* _ebo;
+};
\ No newline at end of file
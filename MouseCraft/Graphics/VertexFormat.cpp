@@ -0,0 +1,72 @@
+#include "VertexFormat.h"
+#include "Geometry.h"
+#include <glm/gtc/packing.hpp>
+#include <cstddef>
+
+using std::vector;
+using glm::vec3;
+using glm::vec4;
+
+static_assert(sizeof(PackedVertex) == 24, "PackedVertex should have no padding");
+
+void PackedMesh::clear() {
+	vertices.clear();
+	indexWords.clear();
+	indexType = GL_UNSIGNED_INT;
+	indexCount = 0;
+}
+
+void VertexFormat::pack(Geometry& geometry, PackedMesh& out) {
+	const vector<GLfloat>& positions = geometry.getVertexData();
+	const vector<GLfloat>& normals = geometry.getNormalData();
+	const vector<GLfloat>& texCoords = geometry.getTexCoordData();
+	const vector<GLuint>& indices = geometry.getIndices();
+	const vector<GLfloat>& smoothNormals = geometry.getSmoothNormalData().size() == positions.size() ?
+		geometry.getSmoothNormalData() : normals;
+	size_t count = positions.size() / 3;
+
+	out.clear();
+	out.vertices.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		PackedVertex& v = out.vertices[i];
+		v.position[0] = positions[i * 3];
+		v.position[1] = positions[i * 3 + 1];
+		v.position[2] = positions[i * 3 + 2];
+		v.normal = i * 3 + 2 < normals.size() ?
+			packNormal(vec3(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2])) : 0;
+		v.smoothNormal = i * 3 + 2 < smoothNormals.size() ?
+			packNormal(vec3(smoothNormals[i * 3], smoothNormals[i * 3 + 1], smoothNormals[i * 3 + 2])) : 0;
+		bool hasTexCoord = i * 2 + 1 < texCoords.size();
+		v.texCoord[0] = hasTexCoord ? glm::packHalf1x16(texCoords[i * 2]) : 0;
+		v.texCoord[1] = hasTexCoord ? glm::packHalf1x16(texCoords[i * 2 + 1]) : 0;
+	}
+
+	out.indexCount = indices.size();
+	if (count <= 65536) {
+		// Indices are relative to the mesh's base vertex, so small meshes fit in 16 bits
+		out.indexType = GL_UNSIGNED_SHORT;
+		out.indexWords.resize((indices.size() + 1) / 2);
+		for (size_t i = 0; i < indices.size(); i += 2) {
+			GLuint high = i + 1 < indices.size() ? indices[i + 1] : 0;
+			out.indexWords[i / 2] = (indices[i] & 0xFFFF) | (high << 16);
+		}
+	}
+	else {
+		out.indexType = GL_UNSIGNED_INT;
+		out.indexWords.assign(indices.begin(), indices.end());
+	}
+}
+
+void VertexFormat::setAttributes(VertexArrayObject& vao, VertexBufferObject& vbo) {
+	GLsizei stride = sizeof(PackedVertex);
+	vao.setAttribute(0, vbo, 3, GL_FLOAT, false, stride, offsetof(PackedVertex, position));
+	vao.setAttribute(1, vbo, 4, GL_INT_2_10_10_10_REV, true, stride, offsetof(PackedVertex, normal));
+	vao.setAttribute(2, vbo, 2, GL_HALF_FLOAT, false, stride, offsetof(PackedVertex, texCoord));
+	vao.setAttribute(3, vbo, 4, GL_INT_2_10_10_10_REV, true, stride, offsetof(PackedVertex, smoothNormal));
+}
+
+GLuint VertexFormat::packNormal(const vec3& normal) {
+	float length = glm::length(normal);
+	vec3 n = length > 0.0f ? normal / length : vec3(0.0f);
+	return glm::packSnorm3x10_1x2(vec4(n, 0.0f));
+}
\ No newline at end of file
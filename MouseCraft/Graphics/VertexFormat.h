@@ -0,0 +1,60 @@
+#pragma once
+#include "../GL/glad.h"
+#include "BufferObjects/VertexArrayObject.h"
+#include "BufferObjects/VertexBufferObject.h"
+#include <glm/glm.hpp>
+#include <vector>
+
+class Geometry;
+
+/// <summary>
+/// One vertex in the renderer's interleaved layout, 24 bytes instead of the
+/// 44 bytes the float arrays in Geometry spread across four streams
+/// </summary>
+struct PackedVertex {
+	GLfloat position[3];
+	// Signed normalized 10:10:10:2 (GL_INT_2_10_10_10_REV), w unused
+	GLuint normal;
+	GLuint smoothNormal;
+	// Half floats, so tiling coordinates outside [0, 1] survive
+	GLhalf texCoord[2];
+};
+
+/// <summary>
+/// A geometry converted to the layout the mesh arena stores
+/// </summary>
+struct PackedMesh {
+	std::vector<PackedVertex> vertices;
+	// Two 16 bit indices per word when indexType is GL_UNSIGNED_SHORT, the last word padded with 0
+	std::vector<GLuint> indexWords;
+	GLenum indexType;
+	GLuint indexCount;
+
+	void clear();
+};
+
+/// <summary>
+/// Converts geometry to the compact interleaved vertex layout and describes it to VAOs
+/// </summary>
+class VertexFormat {
+public:
+	/// <summary>
+	/// Pack a geometry's float arrays. Smooth normals fall back to the normals when
+	/// none were generated, and meshes under 65536 vertices get 16 bit indices.
+	/// </summary>
+	/// <param name="geometry">The geometry to read</param>
+	/// <param name="out">Receives the packed mesh, reusing its storage</param>
+	static void pack(Geometry& geometry, PackedMesh& out);
+
+	/// <summary>
+	/// Point attributes 0-3 (position, normal, texture coordinate, smooth normal) at packed vertices
+	/// </summary>
+	/// <param name="vao">The VAO to set up</param>
+	/// <param name="vbo">The buffer holding PackedVertex data</param>
+	static void setAttributes(VertexArrayObject& vao, VertexBufferObject& vbo);
+
+	/// <summary>
+	/// Pack a unit vector into signed normalized 10:10:10:2
+	/// </summary>
+	static GLuint packNormal(const glm::vec3& normal);
+};
\ No newline at end of file
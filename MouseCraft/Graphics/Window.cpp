@@ -7,8 +7,6 @@ using std::string;
 using std::cout;
 using std::endl;
 
-// TODO: Change width and height when window is resized
-
 Window::Window(string title, int width, int height) : _width(width), _height(height) {
 	static const int x = SDL_WINDOWPOS_UNDEFINED;
 	static const int y = SDL_WINDOWPOS_UNDEFINED;
@@ -31,7 +29,8 @@ Window::Window(string title, int width, int height) : _width(width), _height(hei
 	SDL_GL_SetAttribute(SDL_GL_FRAMEBUFFER_SRGB_CAPABLE, 1);
 	SDL_GL_SetSwapInterval(1);
 
-	_sdlWindow = SDL_CreateWindow(cTitle, x, y, width, height, SDL_WINDOW_OPENGL);
+	// The renderer sizes its targets to the window every frame, so it can be resized freely
+	_sdlWindow = SDL_CreateWindow(cTitle, x, y, width, height, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
 	RenderUtil::sdlErrorOnNotSuccess(_sdlWindow == nullptr, "Window Creation", false);
 
 	_context = SDL_GL_CreateContext(_sdlWindow);
@@ -57,9 +56,11 @@ SDL_GLContext Window::getContext() {
 }
 
 int Window::getWidth() {
+	SDL_GetWindowSize(_sdlWindow, &_width, &_height);
 	return _width;
 }
 
 int Window::getHeight() {
+	SDL_GetWindowSize(_sdlWindow, &_width, &_height);
 	return _height;
 }
\ No newline at end of file
@@ -28,4 +28,5 @@ void HealthDisplay::setWatchingHealthComponent(HealthComponent* component) {
 
 void HealthDisplay::updateHealthUI(int health) {
 	_healthUI->size.x = _maxWidth * health / _maxHealth;
+	_healthUI->valid = false;
 }
\ No newline at end of file
@@ -456,6 +456,12 @@ void HostScene::InitScene() {
 	root.AddChild(jumpingTeapot);
 	root.AddChild(jumpingTeapot2);
 
+    //The map never moves, so the renderer merges it into a few static batches
+    for (Entity* e : { floorEntity, counter1Entity, counter2Entity, islandEntity, tableEntity, couchEntity,
+        catstandEntity, northWallEntity, southWallEntity, westWallEntity, eastWallEntity }) {
+        e->SetStatic(true);
+    }
+
 }
 
 void HostScene::CleanUp() {
@@ -187,7 +187,7 @@ void InputSystem::Update(float dt)
 			}
 
 			// notify
-			EventManager::Notify(EventName::INPUT_BUTTON,
+			EventManager::Notify(EventName::INPUT_BUTTON, player,
 				new TypeParam<ButtonEvent>(ButtonEvent{ player, b, isDown }));
 		}
 		else if (e.type == SDL_KEYDOWN || e.type == SDL_KEYUP)
@@ -212,23 +212,23 @@ void InputSystem::Update(float dt)
 				dkRight = (isDown) ? 1 : 0;
 				break;
 			case SDLK_j:
-				EventManager::Notify(EventName::INPUT_BUTTON,
+				EventManager::Notify(EventName::INPUT_BUTTON, player,
 					new TypeParam<ButtonEvent>(ButtonEvent{ player, Button::PRIMARY, isDown }));
 				break;
 			case SDLK_k:
-				EventManager::Notify(EventName::INPUT_BUTTON,
+				EventManager::Notify(EventName::INPUT_BUTTON, player,
 					new TypeParam<ButtonEvent>(ButtonEvent{ player, Button::SECONDARY, isDown }));
 				break;
 			case SDLK_l:
-				EventManager::Notify(EventName::INPUT_BUTTON,
+				EventManager::Notify(EventName::INPUT_BUTTON, player,
 					new TypeParam<ButtonEvent>(ButtonEvent{ player, Button::AUX1, isDown }));
 				break;
 			case SDLK_SEMICOLON:
-				EventManager::Notify(EventName::INPUT_BUTTON,
+				EventManager::Notify(EventName::INPUT_BUTTON, player,
 					new TypeParam<ButtonEvent>(ButtonEvent{ player, Button::AUX2, isDown }));
 				break;
             case SDLK_RETURN:
-                EventManager::Notify(EventName::INPUT_BUTTON,
+                EventManager::Notify(EventName::INPUT_BUTTON, player,
 					new TypeParam<ButtonEvent>(ButtonEvent{ player, Button::OPTION, isDown }));
                 break;
             }
@@ -302,17 +302,17 @@ void InputSystem::NotifyAxis(Axis2DInput& axis, Axis which, int player)
 {
 	if (axis.HasAxisChanged())
 	{
-		EventManager::Notify(EventName::INPUT_AXIS_2D,
+		EventManager::Notify(EventName::INPUT_AXIS_2D, player,
 			new TypeParam<Axis2DEvent>(Axis2DEvent{ player, which, axis.GetAxis() }));
 	}
 	if (axis.HasXChanged())
 	{
-		EventManager::Notify(EventName::INPUT_AXIS,
+		EventManager::Notify(EventName::INPUT_AXIS, player,
 			new TypeParam<AxisEvent>(AxisEvent{ player, static_cast<Axis>(which + 1), axis.GetX() }));
 	}
 	if (axis.HasYChanged())
 	{
-		EventManager::Notify(EventName::INPUT_AXIS,
+		EventManager::Notify(EventName::INPUT_AXIS, player,
 			new TypeParam<AxisEvent>(AxisEvent{ player, static_cast<Axis>(which + 2), axis.GetY() }));
 	}
 }
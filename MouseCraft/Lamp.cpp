@@ -18,9 +18,9 @@ void Lamp::OnInitialized()
 {
 	auto physics = GetEntity()->GetComponent<PhysicsComponent>();
 	if (physics->isUp)
-		_checkFor = { PhysObjectType::MOUSE_UP };
+		_checkFor = PhysObjectType::mask(PhysObjectType::MOUSE_UP);
 	else
-		_checkFor = { PhysObjectType::MOUSE_DOWN };
+		_checkFor = PhysObjectType::mask(PhysObjectType::MOUSE_DOWN);
 }
 
 void Lamp::Update(float deltaTime)
@@ -35,10 +35,11 @@ void Lamp::Update(float deltaTime)
 			auto pos = GetEntity()->t().wPos();
 			auto bl = pos + glm::vec3(-0.5, 0, -0.5) * FIELD_RANGE;
 			auto tr = pos + glm::vec3(0.5, 0, 0.5) * FIELD_RANGE;
-			auto hits = PhysicsManager::instance()->areaCheck(nullptr, _checkFor, new Vector2D(bl.x, bl.z), new Vector2D(tr.x, tr.z));
-			for (auto& p : hits)
+			PhysicsComponent* hits[MAX_QUERY_RESULTS];
+			size_t hitCount = PhysicsManager::instance()->areaQuery(_checkFor, Vector2D(bl.x, bl.z), Vector2D(tr.x, tr.z), hits, MAX_QUERY_RESULTS);
+			for (size_t i = 0; i < hitCount; i++)
 			{
-				auto health = p->GetEntity()->GetComponent<HealthComponent>();
+				auto health = hits[i]->GetEntity()->GetComponent<HealthComponent>();
 				health->Damage(1);
 			}
 		}
@@ -2,6 +2,9 @@
 #include <fstream>
 #include <iostream>
 #include "ObjFileParser.h"
+#include "../Graphics/ModelGen.h"
+#include "../Graphics/MeshOptimizer.h"
+#include "../Graphics/MeshSimplifier.h"
 
 using std::ifstream;
 using std::string;
@@ -40,6 +43,22 @@ Model* ModelLoader::loadModel(string filename) {
 	Geometry* g = new Geometry();
 	vector<aiMesh*> meshes = processNode(scene->mRootNode, scene);
 	processMeshes(meshes, scene, g);
+
+	MeshOptimizer::Stats before, after;
+	MeshOptimizer::optimize(g, &before, &after);
+	std::cout << "Optimized " << filename << ": " << before.vertices << " -> " << after.vertices
+		<< " vertices, ACMR " << before.acmr << " -> " << after.acmr << std::endl;
+
+	// Smooth normals and packing read the optimized vertices
+	ModelGen::generateSmoothNormals(g);
+	g->pack();
+
+	// Simplified levels copy the smooth normals, so they're built last
+	MeshSimplifier::generateLODs(g);
+	if (g->getLODCount() > 1) {
+		std::cout << "Generated " << g->getLODCount() - 1 << " LODs for " << filename << ", down to "
+			<< g->getLOD(g->getLODCount() - 1)->getIndices().size() / 3 << " triangles" << std::endl;
+	}
 	return new Model(g);
 }
 
@@ -61,7 +80,7 @@ void ModelLoader::processMeshes(vector<aiMesh*>& meshes, const aiScene* scene, G
 	std::vector<GLfloat> vertNormals;
 	std::vector<GLfloat> vertTexCoord;
 	std::vector<GLuint> indices;
-	int meshStartIndex = 0;
+	GLuint meshStartVertex = 0;
 	for (aiMesh* mesh : meshes) {
 		bool hasTex = mesh->mTextureCoords[0];
 		for (int i = 0; i < mesh->mNumVertices; i++) {
@@ -87,10 +106,10 @@ void ModelLoader::processMeshes(vector<aiMesh*>& meshes, const aiScene* scene, G
 		for (int i = 0; i < mesh->mNumFaces; i++) {
 			aiFace face = mesh->mFaces[i];
 			for (int j = 0; j < face.mNumIndices; j++) {
-				indices.push_back(face.mIndices[j] + meshStartIndex);
+				indices.push_back(face.mIndices[j] + meshStartVertex);
 			}
 		}
-		meshStartIndex = indices.size();
+		meshStartVertex += mesh->mNumVertices;
 	}
 	g->setVertexData(vertPositions);
 	g->setNormalData(vertNormals);
@@ -0,0 +1,106 @@
+#include "TextureCache.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+using std::string;
+using std::vector;
+using std::ifstream;
+using std::ofstream;
+
+// "MCMP", bump the version when the filtering or layout changes
+#define CACHE_MAGIC 0x504D434D
+#define CACHE_VERSION 1
+
+bool TextureCache::load(const string& sourcePath, int maxSize, vector<MipLevel>& levels) {
+	uint64_t size;
+	int64_t time;
+	if (!sourceStamp(sourcePath, size, time)) {
+		return false;
+	}
+
+	ifstream file(cachePath(sourcePath), std::ios::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	Header header;
+	file.read((char*)&header, sizeof(Header));
+	if (!file || header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+		header.sourceSize != size || header.sourceTime != time || header.maxSize != maxSize) {
+		return false;
+	}
+
+	// A chain from maxSize down to 1x1 has at most log2(maxSize) + 1 levels
+	int maxLevels = 1;
+	for (int s = maxSize; s > 1; s /= 2) {
+		maxLevels++;
+	}
+	if (header.levelCount <= 0 || header.levelCount > maxLevels) {
+		return false;
+	}
+
+	levels.resize(header.levelCount);
+	for (size_t i = 0; i < levels.size(); i++) {
+		MipLevel& level = levels[i];
+		int32_t dimensions[2];
+		file.read((char*)dimensions, sizeof(dimensions));
+		if (!file || dimensions[0] <= 0 || dimensions[1] <= 0 || dimensions[0] > maxSize || dimensions[1] > maxSize) {
+			levels.clear();
+			return false;
+		}
+		// Every level halves the one before, as the filter builds them
+		if (i > 0 && (dimensions[0] != std::max(levels[i - 1].width / 2, 1) || dimensions[1] != std::max(levels[i - 1].height / 2, 1))) {
+			levels.clear();
+			return false;
+		}
+		level.width = dimensions[0];
+		level.height = dimensions[1];
+		level.pixels.resize(level.width * level.height * 4);
+		file.read((char*)&level.pixels[0], level.pixels.size());
+	}
+	if (!file) {
+		levels.clear();
+		return false;
+	}
+	return !levels.empty();
+}
+
+void TextureCache::save(const string& sourcePath, int maxSize, const vector<MipLevel>& levels) {
+	Header header;
+	header.magic = CACHE_MAGIC;
+	header.version = CACHE_VERSION;
+	header.maxSize = maxSize;
+	header.levelCount = levels.size();
+	if (!sourceStamp(sourcePath, header.sourceSize, header.sourceTime)) {
+		return;
+	}
+
+	ofstream file(cachePath(sourcePath), std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		std::cerr << "Could not write texture cache for " << sourcePath << std::endl;
+		return;
+	}
+	file.write((const char*)&header, sizeof(Header));
+	for (const MipLevel& level : levels) {
+		int32_t dimensions[2] = { level.width, level.height };
+		file.write((const char*)dimensions, sizeof(dimensions));
+		file.write((const char*)&level.pixels[0], level.pixels.size());
+	}
+}
+
+string TextureCache::cachePath(const string& sourcePath) {
+	return sourcePath + ".mipcache";
+}
+
+bool TextureCache::sourceStamp(const string& sourcePath, uint64_t& size, int64_t& time) {
+	struct stat info;
+	if (stat(sourcePath.c_str(), &info) != 0) {
+		return false;
+	}
+	size = info.st_size;
+	time = info.st_mtime;
+	return true;
+}
\ No newline at end of file
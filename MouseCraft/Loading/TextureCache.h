@@ -0,0 +1,25 @@
+#pragma once
+#include "../Graphics/TextureFilter.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Stores finished mip chains next to their source image so later runs skip decoding and filtering.
+// A cache file is only used while the source file's size and modification time still match.
+class TextureCache {
+public:
+	static bool load(const std::string& sourcePath, int maxSize, std::vector<MipLevel>& levels);
+	static void save(const std::string& sourcePath, int maxSize, const std::vector<MipLevel>& levels);
+private:
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		int32_t maxSize;
+		int32_t levelCount;
+	};
+
+	static std::string cachePath(const std::string& sourcePath);
+	static bool sourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& time);
+};
\ No newline at end of file
@@ -8,15 +8,12 @@ Mouse::Mouse() :
 	HandleOnRevive(this, &Mouse::OnRevived)
 {
 	std::cout << std::setprecision(2);
-	EventManager::Subscribe(EventName::INPUT_AXIS, this);
-	EventManager::Subscribe(EventName::INPUT_BUTTON, this);
 }
 
 
 Mouse::~Mouse()
 {
-	EventManager::Unsubscribe(EventName::INPUT_AXIS, this);
-	EventManager::Unsubscribe(EventName::INPUT_BUTTON, this);
+	EventManager::Unsubscribe(EventName::INPUT_BUTTON, player, this);
 }
 
 void Mouse::OnInitialized() 
@@ -28,6 +25,7 @@ void Mouse::OnInitialized()
 		HandleOnCollide.Observe(_phys->onCollide);
 		HandleOnHit.Observe(_phys->onHit);
 		HandleOnBounce.Observe(_phys->onBounce);
+		_phys->checksFalling = true;
 	}
 
 	// Listen for death 
@@ -36,6 +34,7 @@ void Mouse::OnInitialized()
 	HandleOnRevive.Observe(c_health->OnRevive);
 
     player = GetEntity()->GetComponent<PlayerComponent>()->GetID();
+	EventManager::Subscribe(EventName::INPUT_BUTTON, player, this);
 
 	render = GetEntity()->GetComponent<Renderable>();
 	initialColor = render->getColor();
@@ -56,20 +55,21 @@ void Mouse::Update(float deltaTime)
 		auto tr = pos + glm::vec3(RADIUS, 0, RADIUS);
 		bool isUp = GetEntity()->GetComponent<PhysicsComponent>()->isUp;
 
+		PhysObjectType::PhysObjectMask checkFor;
 		if (isUp) {
-			checkFor.insert(PhysObjectType::MOUSE_UP);
+			checkFor = PhysObjectType::mask(PhysObjectType::MOUSE_UP);
 		}
 		else
 		{
-			checkFor.insert(PhysObjectType::MOUSE_DOWN);
-			checkFor.insert(PhysObjectType::PART);
+			checkFor = PhysObjectType::mask(PhysObjectType::MOUSE_DOWN) | PhysObjectType::mask(PhysObjectType::PART);
 		}
 
-		auto hits = _phys->areaCheck(checkFor, new Vector2D(bl.x, bl.z), new Vector2D(tr.x, tr.z));
-		bool hit = hits.size() > 0;
+		PhysicsComponent* hits[MAX_QUERY_RESULTS];
+		size_t hitCount = _phys->areaQuery(checkFor, Vector2D(bl.x, bl.z), Vector2D(tr.x, tr.z), hits, MAX_QUERY_RESULTS);
 
-		for (auto pc : hits)
+		for (size_t i = 0; i < hitCount; i++)
 		{
+			PhysicsComponent* pc = hits[i];
 			if (pc->pType == PhysObjectType::MOUSE_DOWN || pc->pType == PhysObjectType::MOUSE_UP)
 			{
 				revive(pc);
@@ -100,8 +100,6 @@ void Mouse::Update(float deltaTime)
 			disassemble();
 		}
 	}
-
-	_phys->updateFalling();
 }
 
 void Mouse::Notify(EventName eventName, Param * params)
@@ -114,9 +112,6 @@ void Mouse::Notify(EventName eventName, Param * params)
 	{
 		auto data = static_cast<TypeParam<ButtonEvent>*>(params)->Param;
 
-		if (data.player != player)
-			return;
-
 		if (data.button == Button::PRIMARY && data.isDown)
 			interact = true;	// or do it right away, no post processing required.
 
@@ -144,18 +139,14 @@ void Mouse::OnBounce(PhysicsComponent* e)
 	PhysicsComponent* pComp = GetEntity()->GetComponent<PhysicsComponent>();
 
 	//position of mouse
-	Vector2D* curPos = new Vector2D(GetEntity()->transform.getLocalPosition().x, GetEntity()->transform.getLocalPosition().z);
+	Vector2D curPos(GetEntity()->transform.getLocalPosition().x, GetEntity()->transform.getLocalPosition().z);
 	//vector in front of cat of length = JUMP_DIST
-	Vector2D* jumpVec = new Vector2D(GetEntity()->transform.getLocalForward().x * MOUSE_JUMP_DIST, GetEntity()->transform.getLocalForward().z * MOUSE_JUMP_DIST);
-	jumpVec = new Vector2D(*curPos + *jumpVec);
-
-	std::set<PhysObjectType::PhysObjectType> types = std::set<PhysObjectType::PhysObjectType>{
-		PhysObjectType::PLATFORM
-	};
+	Vector2D jumpVec(GetEntity()->transform.getLocalForward().x * MOUSE_JUMP_DIST, GetEntity()->transform.getLocalForward().z * MOUSE_JUMP_DIST);
+	jumpVec = curPos + jumpVec;
 
-	Vector2D* hitPos = new Vector2D(0, 0);
+	Vector2D hitPos(0, 0);
 
-	PhysicsComponent* jumpTarget = pComp->rayCheck(types, curPos, jumpVec, *hitPos);
+	PhysicsComponent* jumpTarget = pComp->rayQuery(PhysObjectType::mask(PhysObjectType::PLATFORM), curPos, jumpVec, hitPos);
 
 	//check if we are in a location we can jump in
 	if (jumpTarget != nullptr) {
@@ -73,7 +73,6 @@ private:
 	Pickup* baseItem;
 	Contraption* newItem;
 	PhysicsComponent* _phys;
-	std::set<PhysObjectType::PhysObjectType> checkFor;
 	PhysicsComponent* _collidedObjects;
 
 	static Component* Create(json json);
@@ -284,7 +284,7 @@ void NetworkSystem::processDatum(const Address &sender, PacketData *packet) {
                 glm::vec2 value(x, y);
 
 				Axis2DEvent eventData{ _connectionList[sender].PlayerID, axis, value };
-                EventManager::Notify(EventName::INPUT_AXIS_2D, new TypeParam<Axis2DEvent>(eventData));
+                EventManager::Notify(EventName::INPUT_AXIS_2D, eventData.player, new TypeParam<Axis2DEvent>(eventData));
             }
             break;
         case NetDatum::DataType::PLAYER_BUTTON:
@@ -293,7 +293,7 @@ void NetworkSystem::processDatum(const Address &sender, PacketData *packet) {
                 bool down = packet->ReadByte();
 
 				ButtonEvent eventData{ _connectionList[sender].PlayerID, button, down };
-                EventManager::Notify(EventName::INPUT_BUTTON, new TypeParam<ButtonEvent>(eventData));
+                EventManager::Notify(EventName::INPUT_BUTTON, eventData.player, new TypeParam<ButtonEvent>(eventData));
             }
             break;
         default:
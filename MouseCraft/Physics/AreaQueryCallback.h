@@ -1,14 +1,30 @@
+#pragma once
 #include <Box2D/Box2D.h>
-#include <vector>
+#include <cstddef>
+#include "PhysObjectType.h"
+#include "PhysicsComponent.h"
 
+//collects the components of the types in the mask into a caller's array
 class AreaQueryCallback : public b2QueryCallback
 {
 public:
-	std::vector<b2Body*> foundBodies;
+	AreaQueryCallback(PhysObjectType::PhysObjectMask typeMask, PhysicsComponent** results, size_t capacity)
+		: typeMask(typeMask), results(results), capacity(capacity), count(0)
+	{
+	}
+
+	PhysObjectType::PhysObjectMask typeMask;
+	PhysicsComponent** results;
+	size_t capacity;
+	size_t count;
 
 	bool ReportFixture(b2Fixture* fixture)
 	{
-		foundBodies.push_back(fixture->GetBody());
-		return true; //continues checking for more fixtures if it returns true
+		PhysicsComponent* pComp = static_cast<PhysicsComponent*>(fixture->GetBody()->GetUserData());
+
+		if (typeMask & PhysObjectType::mask(pComp->pType))
+			results[count++] = pComp;
+
+		return count < capacity; //stops checking once the array is full
 	}
 };
\ No newline at end of file
@@ -20,4 +20,12 @@ namespace PhysObjectType
 		BALL_UP,
 		BALL_DOWN
 	};
+
+	//a set of types for physics queries, one bit per type
+	typedef unsigned int PhysObjectMask;
+
+	constexpr PhysObjectMask mask(PhysObjectType t)
+	{
+		return 1u << t;
+	}
 }
\ No newline at end of file
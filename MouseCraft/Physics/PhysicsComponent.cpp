@@ -9,6 +9,8 @@ PhysicsComponent::PhysicsComponent(PhysObjectType::PhysObjectType t, float z, fl
 	zPos = z;
 	rotation = r;
 	isJumping = false;
+	isFalling = false;
+	checksFalling = false;
 	pType = t;
 }
 
@@ -27,6 +29,12 @@ PhysicsComponent::~PhysicsComponent()
 			removeFromGrid();
 			break;
 		}
+
+		if (pType == PhysObjectType::PLATFORM && PhysicsManager::instance()->getGrid() != nullptr)
+		{
+			auto pos = body->GetPosition();
+			PhysicsManager::instance()->getGrid()->removePlatform(pos.x - (width / 2), pos.y - (height / 2), pos.x + (width / 2), pos.y + (height / 2));
+		}
 	}
 
 	body->GetWorld()->DestroyBody(body);
@@ -43,14 +51,14 @@ void PhysicsComponent::moveBody(Vector2D* pos, float angle)
 	body->SetTransform(b2Vec2(pos->x, pos->y), angle);
 }
 
-std::vector<PhysicsComponent*> PhysicsComponent::areaCheck(std::set<PhysObjectType::PhysObjectType> toCheck, Vector2D* p1, Vector2D* p2)
+size_t PhysicsComponent::areaQuery(PhysObjectType::PhysObjectMask toCheck, const Vector2D& p1, const Vector2D& p2, PhysicsComponent** results, size_t capacity)
 {
-	return PhysicsManager::instance()->areaCheck(this, toCheck, p1, p2);
+	return PhysicsManager::instance()->areaQuery(toCheck, p1, p2, results, capacity);
 }
 
-PhysicsComponent* PhysicsComponent::rayCheck(std::set<PhysObjectType::PhysObjectType> toCheck, Vector2D* p1, Vector2D* p2, Vector2D& hit)
+PhysicsComponent* PhysicsComponent::rayQuery(PhysObjectType::PhysObjectMask toCheck, const Vector2D& p1, const Vector2D& p2, Vector2D& hit)
 {
-	return PhysicsManager::instance()->rayCheck(this, toCheck, p1, p2, hit);
+	return PhysicsManager::instance()->rayQuery(toCheck, p1, p2, hit);
 }
 
 void PhysicsComponent::jump()
@@ -68,18 +76,11 @@ bool PhysicsComponent::updateFalling()
 {
 	if (!isJumping && isUp && !isFalling)
 	{
-		std::set<PhysObjectType::PhysObjectType> types = std::set<PhysObjectType::PhysObjectType>{
-			PhysObjectType::PLATFORM
-		};
-
 		auto compPos = body->GetPosition();
-		Vector2D* p1 = new Vector2D(compPos.x - (width / 2), compPos.y - (height / 2));
-		Vector2D* p2 = new Vector2D(compPos.x + (width / 2), compPos.y + (height / 2));
-
-		std::vector<PhysicsComponent*> found = areaCheck(types, p1, p2);
+		WorldGrid* grid = PhysicsManager::instance()->getGrid();
 
 		//if you aren't on a platform then fall
-		if (found.size() == 0)
+		if (grid == nullptr || !grid->platformInArea(compPos.x - (width / 2), compPos.y - (height / 2), compPos.x + (width / 2), compPos.y + (height / 2)))
 		{
 			fall();
 			return true;
@@ -105,7 +106,12 @@ void PhysicsComponent::removeCollisions()
 
 void PhysicsComponent::removeFromGrid()
 {
-	PhysicsManager::instance()->getGrid()->removeObject(body->GetPosition().x, body->GetPosition().y);
+	WorldGrid* grid = PhysicsManager::instance()->getGrid();
+	if (grid == nullptr)
+		return;
+
+	auto pos = body->GetPosition();
+	grid->removeComponent(this, pos.x - (width / 2), pos.y - (height / 2), pos.x + (width / 2), pos.y + (height / 2));
 }
 
 Component* PhysicsComponent::Create(json json)
@@ -19,8 +19,8 @@ public:
 	~PhysicsComponent();
 	void initPosition();
 	void moveBody(Vector2D* pos, float angle);
-	std::vector<PhysicsComponent*> areaCheck(std::set<PhysObjectType::PhysObjectType> toCheck, Vector2D* p1, Vector2D* p2);
-	PhysicsComponent* rayCheck(std::set<PhysObjectType::PhysObjectType> toCheck, Vector2D* p1, Vector2D* p2, Vector2D& hit);
+	size_t areaQuery(PhysObjectType::PhysObjectMask toCheck, const Vector2D& p1, const Vector2D& p2, PhysicsComponent** results, size_t capacity);
+	PhysicsComponent* rayQuery(PhysObjectType::PhysObjectMask toCheck, const Vector2D& p1, const Vector2D& p2, Vector2D& hit);
 	bool updateFalling();
 	void makeDynamic();
 	void jump();
@@ -34,6 +34,7 @@ public:
 	Vector2D velocity;
 	float zPos, zVelocity, rotation, width, height;
 	bool isJumping, isFalling, isUp;
+	bool checksFalling; //if set the physics manager drops this off the upper level when it leaves the platforms
 	b2Body* body;
 	PhysObjectType::PhysObjectType pType;
 	Subject<PhysicsComponent*> onCollide; //for collision between bodies
@@ -1,4 +1,6 @@
 #include "PhysicsManager.h"
+#include "AreaQueryCallback.h"
+#include "RayQueryCallback.h"
 
 PhysicsManager* PhysicsManager::pmInstance;
 
@@ -12,6 +14,8 @@ PhysicsManager::PhysicsManager()
 	cListener->setup();
 	world->SetContactListener(cListener);
 
+	grid = nullptr;
+
 	profiler.InitializeTimers(4);
 	profiler.LogOutput("Physics.log");	// optional
 }
@@ -78,7 +82,8 @@ void PhysicsManager::Update(float dt)
 		//Advance each physics world
 		world->Step(ts, 10, 10);
 
-		//Update the heights of characters based on gravity and jumping
+		//Drop anything that walked off a platform, then update the heights of characters based on gravity and jumping
+		checkFalling();
 		updateHeights(ts);
 
 		//Check for collisions in each physics world
@@ -90,6 +95,7 @@ void PhysicsManager::Update(float dt)
 	if (t < dt)
 	{
 		world->Step(dt - t, 10, 10);
+		checkFalling();
 		updateHeights(dt - t);
 		checkCollisions();
 	}
@@ -237,28 +243,28 @@ PhysicsComponent* PhysicsManager::createGridObject(float x, float y, int w, int
 
 	b2BodyDef bodyDef;
 	bodyDef.active = true;	//wait for component to be active (valid state)
-	Vector2D *p1 = new Vector2D(0, 0), *p2 = new Vector2D(0, 0);
+	Vector2D p1(0, 0), p2(0, 0);
 
 	switch (t)
 	{
 	case PhysObjectType::OBSTACLE_UP:
 	case PhysObjectType::OBSTACLE_DOWN:
 	case PhysObjectType::PLATFORM:
-		p1 = new Vector2D(x - ((float)w / 2), y + ((float)h / 2));
-		p2 = new Vector2D(x + ((float)w / 2), y - ((float)h / 2));
+		p1 = Vector2D(x - ((float)w / 2), y + ((float)h / 2));
+		p2 = Vector2D(x + ((float)w / 2), y - ((float)h / 2));
 
-		grid->positionArea(*p1, *p2);
+		grid->positionArea(p1, p2);
 
-		bodyDef.position.Set(p1->x + ((float)w / 2), p1->y - ((float)h / 2));
+		bodyDef.position.Set(p1.x + ((float)w / 2), p1.y - ((float)h / 2));
 		break;
 	case PhysObjectType::CONTRAPTION_UP:
 	case PhysObjectType::CONTRAPTION_DOWN:
 	case PhysObjectType::PART:
-		p1 = new Vector2D(x, y);
+		p1 = Vector2D(x, y);
 
-		grid->positionObject(*p1);
+		grid->positionObject(p1);
 
-		bodyDef.position.Set(p1->x + grid->scale / 2.0f, p1->y - grid->scale / 2.0f);
+		bodyDef.position.Set(p1.x + grid->scale / 2.0f, p1.y - grid->scale / 2.0f);
 		break;
 	default:
 		return nullptr;
@@ -354,15 +360,22 @@ PhysicsComponent* PhysicsManager::createGridObject(float x, float y, int w, int
 	case PhysObjectType::OBSTACLE_UP:
 	case PhysObjectType::OBSTACLE_DOWN:
 	case PhysObjectType::PLATFORM:
-		grid->createArea(*p1, *p2, physicsComp);
+		grid->createArea(p1, p2, physicsComp);
 		break;
 	case PhysObjectType::CONTRAPTION_UP:
 	case PhysObjectType::CONTRAPTION_DOWN:
 	case PhysObjectType::PART:
-		grid->createObject(*p1, physicsComp);
+		grid->createObject(p1, physicsComp);
 		break;
 	}
 
+	//Platforms are what fall checks look for, so they also go in the grid's occupancy map
+	if (t == PhysObjectType::PLATFORM)
+	{
+		b2Vec2 pos = body->GetPosition();
+		grid->addPlatform(pos.x - ((float)w / 2), pos.y - ((float)h / 2), pos.x + ((float)w / 2), pos.y + ((float)h / 2));
+	}
+
 	return physicsComp;
 }
 
@@ -494,6 +507,24 @@ void PhysicsManager::updateHeights(float step)
 	}
 }
 
+//Check every component that asked for it against the grid's platforms in one pass
+void PhysicsManager::checkFalling()
+{
+	if (grid == nullptr)
+		return;
+
+	for (b2Body* b = world->GetBodyList(); b != NULL; b = b->GetNext())
+	{
+		if (b->GetType() == b2_staticBody || !b->IsActive())
+			continue;
+
+		PhysicsComponent* comp = static_cast<PhysicsComponent*>(b->GetUserData());
+
+		if (comp != nullptr && comp->checksFalling)
+			comp->updateFalling();
+	}
+}
+
 void PhysicsManager::checkCollisions()
 {
 	//If there are any unhandled collisions
@@ -518,117 +549,42 @@ void PhysicsManager::checkCollisions()
 	cListener->resetCollided();
 }
 
-//returns a list of the objects hit
-std::vector<PhysicsComponent*> PhysicsManager::areaCheck(PhysicsComponent * checkedBy, Vector2D * p1, Vector2D * p2)
-{
-	std::vector<PhysicsComponent*> foundObjects;
-
-	AreaQueryCallback callback;
-
-	b2AABB boundingBox;
-	boundingBox.lowerBound = b2Vec2(p1->x, p1->y);
-	boundingBox.upperBound = b2Vec2(p2->x, p2->y);
-
-	world->QueryAABB(&callback, boundingBox);
-
-	for (int i = 0; i < callback.foundBodies.size(); i++)
-	{
-		PhysicsComponent* pComp = static_cast<PhysicsComponent*>(callback.foundBodies[i]->GetUserData());
-
-		foundObjects.push_back(pComp);
-	}
-
-	return foundObjects;
-}
-
-//returns a list of the objects hit
-std::vector<PhysicsComponent*> PhysicsManager::areaCheck(PhysicsComponent* checkedBy, std::set<PhysObjectType::PhysObjectType> toCheck, Vector2D* p1, Vector2D* p2)
+//fills results with up to capacity of the objects in the box, returns how many were found
+size_t PhysicsManager::areaQuery(PhysObjectType::PhysObjectMask toCheck, const Vector2D& p1, const Vector2D& p2, PhysicsComponent** results, size_t capacity)
 {
-	std::vector<PhysicsComponent*> foundObjects;
+	if (capacity == 0)
+		return 0;
 
-	AreaQueryCallback callback;
+	AreaQueryCallback callback(toCheck, results, capacity);
 
 	b2AABB boundingBox;
-	boundingBox.lowerBound = b2Vec2(p1->x, p1->y);
-	boundingBox.upperBound = b2Vec2(p2->x, p2->y);
+	boundingBox.lowerBound = b2Vec2(p1.x, p1.y);
+	boundingBox.upperBound = b2Vec2(p2.x, p2.y);
 
 	world->QueryAABB(&callback, boundingBox);
 
-	for (int i = 0; i < callback.foundBodies.size(); i++)
-	{
-		PhysicsComponent* pComp = static_cast<PhysicsComponent*>(callback.foundBodies[i]->GetUserData());
-
-		if (toCheck.find(pComp->pType) != toCheck.end())
-			foundObjects.push_back(pComp);
-	}
-
-	return foundObjects;
+	return callback.count;
 }
 
-//returns the first object hit
-PhysicsComponent * PhysicsManager::rayCheck(PhysicsComponent * checkedBy, Vector2D * p1, Vector2D * p2, Vector2D& hit)
+//returns whether anything is in the box, stopping at the first object found
+bool PhysicsManager::areaAny(PhysObjectType::PhysObjectMask toCheck, const Vector2D& p1, const Vector2D& p2)
 {
-	float32 frac = 1; //used to determine the closest object
-	PhysicsComponent* bestMatch = nullptr;
-	RayQueryCallback callback;
-
-	b2Vec2 point1 = b2Vec2(p1->x, p1->y);
-	b2Vec2 point2 = b2Vec2(p2->x, p2->y);
-
-	world->RayCast(&callback, point1, point2);
-
-	//Find the closest object hit by the ray
-	for (int i = 0; i < callback.hitBodies.size(); i++)
-	{
-		//if the object is further than the best match so far, move on
-		if (callback.fractions[i] > frac)
-			continue;
-
-		PhysicsComponent* pComp = static_cast<PhysicsComponent*>(callback.hitBodies[i]->GetUserData());
-		frac = callback.fractions[i];
-		bestMatch = pComp;
-	}
-
-	return bestMatch;
+	PhysicsComponent* found;
+	return areaQuery(toCheck, p1, p2, &found, 1) > 0;
 }
 
 //returns the first object hit
-PhysicsComponent* PhysicsManager::rayCheck(PhysicsComponent* checkedBy, std::set<PhysObjectType::PhysObjectType> toCheck, Vector2D* p1, Vector2D* p2, Vector2D& hit)
+PhysicsComponent* PhysicsManager::rayQuery(PhysObjectType::PhysObjectMask toCheck, const Vector2D& p1, const Vector2D& p2, Vector2D& hit)
 {
-	float32 frac = 1; //used to determine the closest object
-	PhysicsComponent* bestMatch = nullptr;
-	RayQueryCallback callback;
-
-	b2Vec2 point1 = b2Vec2(p1->x, p1->y);
-	b2Vec2 point2 = b2Vec2(p2->x, p2->y);
-
-	world->RayCast(&callback, point1, point2);
-
-	//Find the closest object hit by the ray
-	for (int i = 0; i < callback.hitBodies.size(); i++)
-	{
-		//if the object is further than the best match so far, move on
-		if (callback.fractions[i] > frac)
-			continue;
-
-		PhysicsComponent* pComp = static_cast<PhysicsComponent*>(callback.hitBodies[i]->GetUserData());
+	RayQueryCallback callback(toCheck);
 
-		if (toCheck.find(pComp->pType) != toCheck.end())
-		{
-			frac = callback.fractions[i];
-			bestMatch = pComp;
-		}
-	}
+	world->RayCast(&callback, b2Vec2(p1.x, p1.y), b2Vec2(p2.x, p2.y));
 
-	if (bestMatch == nullptr)
+	if (callback.hitComponent == nullptr)
 		return nullptr;
 
-	b2Vec2 ray = point2 - point1;
-	ray *= frac;
-	ray = point1 + ray;
-
-	hit = Vector2D(ray.x, ray.y);
-	return bestMatch;
+	hit = Vector2D(callback.hitPoint.x, callback.hitPoint.y);
+	return callback.hitComponent;
 }
 
 WorldGrid* PhysicsManager::getGrid()
@@ -12,8 +12,6 @@
 #include <glm/glm.hpp>
 #include "PhysObjectType.h"
 #include "../Core/Entity.h"
-#include "AreaQueryCallback.h"
-#include "RayQueryCallback.h"
 #include "../Util/CpuProfiler.h"
 #include "../WorldGrid.h"
 
@@ -23,6 +21,8 @@ constexpr auto Z_UPPER = 5.0;
 constexpr auto Z_THRESHOLD = 3.0;
 constexpr auto Z_LOWER = 0.5;
 
+constexpr auto MAX_QUERY_RESULTS = 32;
+
 constexpr auto WALL_CATEGORY = 0x0001;
 constexpr auto PLATFORM_CATEGORY = 0x0002;
 constexpr auto OBSTACLE_DOWN_CATEGORY = 0x0004;
@@ -70,10 +70,9 @@ public:
 	void setupGrid(int w, int h, int scale);
 	PhysicsComponent* createObject(float x, float y, float w, float h, float r, PhysObjectType::PhysObjectType t);
 	PhysicsComponent* createGridObject(float x, float y, int w, int h, PhysObjectType::PhysObjectType t);
-	std::vector<PhysicsComponent*> areaCheck(PhysicsComponent* checkedBy, Vector2D* p1, Vector2D* p2);
-	std::vector<PhysicsComponent*> areaCheck(PhysicsComponent* checkedBy, std::set<PhysObjectType::PhysObjectType> toCheck, Vector2D* p1, Vector2D* p2);
-	PhysicsComponent* rayCheck(PhysicsComponent* checkedBy, Vector2D* p1, Vector2D* p2, Vector2D& hit);
-	PhysicsComponent* rayCheck(PhysicsComponent* checkedBy, std::set<PhysObjectType::PhysObjectType> toCheck, Vector2D* p1, Vector2D* p2, Vector2D& hit);
+	size_t areaQuery(PhysObjectType::PhysObjectMask toCheck, const Vector2D& p1, const Vector2D& p2, PhysicsComponent** results, size_t capacity);
+	bool areaAny(PhysObjectType::PhysObjectMask toCheck, const Vector2D& p1, const Vector2D& p2);
+	PhysicsComponent* rayQuery(PhysObjectType::PhysObjectMask toCheck, const Vector2D& p1, const Vector2D& p2, Vector2D& hit);
 	WorldGrid* getGrid();
 private:
 	static PhysicsManager* pmInstance;
@@ -85,5 +84,6 @@ private:
 	PhysicsManager();
 	~PhysicsManager();
 	void updateHeights(float delta);
+	void checkFalling();
 	void checkCollisions();
 };
\ No newline at end of file
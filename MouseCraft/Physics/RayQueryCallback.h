@@ -1,19 +1,31 @@
+#pragma once
 #include <Box2D/Box2D.h>
-#include <vector>
 #include "PhysObjectType.h"
 #include "PhysicsComponent.h"
 
+//finds the closest component of the types in the mask along the ray
 class RayQueryCallback : public b2RayCastCallback
 {
 public:
-	std::vector<b2Body*> hitBodies;
-	std::vector<float32> fractions;
+	RayQueryCallback(PhysObjectType::PhysObjectMask typeMask)
+		: typeMask(typeMask), hitComponent(nullptr)
+	{
+	}
+
+	PhysObjectType::PhysObjectMask typeMask;
+	PhysicsComponent* hitComponent;
+	b2Vec2 hitPoint;
 
 	float32 ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float32 fraction)
 	{
-		hitBodies.push_back(fixture->GetBody());
-		fractions.push_back(fraction);
+		PhysicsComponent* pComp = static_cast<PhysicsComponent*>(fixture->GetBody()->GetUserData());
+
+		if (!(typeMask & PhysObjectType::mask(pComp->pType)))
+			return -1; //ignore this fixture and keep the ray as it is
+
+		hitComponent = pComp;
+		hitPoint = point;
 
-		return 1; //check the entire ray for things
+		return fraction; //clip the ray here, only closer fixtures are reported from now on
 	}
 };
\ No newline at end of file
@@ -19,6 +19,7 @@ void Pickup::OnInitialized()
 
 void Pickup::Grab()
 {
+	_physics->removeFromGrid();
 	_physics->SetEnabled(false);
 	_rotator->SetEnabled(false);
 	GetEntity()->transform.setLocalRotation(glm::vec3(0.0f));
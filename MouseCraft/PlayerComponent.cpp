@@ -2,9 +2,25 @@
 #include "Input/InputSystem.h"
 
 
+PlayerComponent::~PlayerComponent()
+{
+	EventManager::Unsubscribe(EventName::INPUT_AXIS_2D, _playerID, this);
+}
+
+void PlayerComponent::SetID(unsigned int id)
+{
+	// move our input subscription over to the new player's channel
+	if (_entity != nullptr)
+	{
+		EventManager::Unsubscribe(EventName::INPUT_AXIS_2D, _playerID, this);
+		EventManager::Subscribe(EventName::INPUT_AXIS_2D, id, this);
+	}
+	_playerID = id;
+}
+
 void PlayerComponent::OnInitialized()
 {
-	EventManager::Subscribe(EventName::INPUT_AXIS_2D, this);
+	EventManager::Subscribe(EventName::INPUT_AXIS_2D, _playerID, this);
 	_entity = GetEntity();
 	_health = _entity->GetComponent<HealthComponent>();
 	_physicsComponent = _entity->GetComponent<PhysicsComponent>();
@@ -18,9 +34,6 @@ void PlayerComponent::Notify(EventName eventName, Param* params)
 	{
 		auto data = static_cast<TypeParam<Axis2DEvent>*>(params)->Param;
 		
-		if (data.player != _playerID)
-			return;
-		
 		if (data.axis == Axis::LEFT)
 		{
 			_move = data.GetClamped();
@@ -19,29 +19,31 @@ enum Team
 class PlayerComponent : public UpdatableComponent
 {
 public:
+	~PlayerComponent();
 	virtual void OnInitialized();
 	Team GetTeam() { return _teamID; }
 	void SetTeam(Team id) { _teamID = id; }
 	unsigned int GetID() { return _playerID; }
-	void SetID(unsigned int id) { _playerID = id; }
+	void SetID(unsigned int id);
 	void SetSpeed(float speed) { _speed = speed; }
 	float GetSpeed() { return _speed; }
 	void SetDisabled(bool b) { _isDisabled = b; }
 
 
 private:
-	HealthComponent* _health;
-	unsigned int _playerID;
-	Team _teamID;
+	HealthComponent* _health = nullptr;
+	// Also the input channel subscribed to, prefabs without an id listen to player 0
+	unsigned int _playerID = 0;
+	Team _teamID = Team::MOUSE;
 	bool _isDisabled = false;
 
-	Entity* _entity;
-	glm::vec2 _move;
-	glm::vec2 _aim;
+	Entity* _entity = nullptr;
+	glm::vec2 _move = glm::vec2(0.0f);
+	glm::vec2 _aim = glm::vec2(0.0f);
 	float _speed = 50.0f;
 
 	// physics component 
-	PhysicsComponent* _physicsComponent;
+	PhysicsComponent* _physicsComponent = nullptr;
 
 	// Inherited via ISubscriber
 	virtual void Notify(EventName eventName, Param * params) override;
@@ -19,14 +19,15 @@ bool Swords::use(Mouse* m) {
 	_phys = GetEntity()->GetComponent<PhysicsComponent>();
 	bool isUp = GetEntity()->GetParent()->GetComponent<PhysicsComponent>()->isUp;
 
+	PhysObjectType::PhysObjectMask checkFor;
 	if (isUp) {
-		checkFor.insert(PhysObjectType::CAT_UP);
-		//checkFor.insert(PhysObjectType::OBSTACLE_UP);
+		checkFor = PhysObjectType::mask(PhysObjectType::CAT_UP);
+		//checkFor |= PhysObjectType::mask(PhysObjectType::OBSTACLE_UP);
 	}
 	else 
 	{
-		checkFor.insert(PhysObjectType::CAT_DOWN);
-		//checkFor.insert(PhysObjectType::OBSTACLE_DOWN);
+		checkFor = PhysObjectType::mask(PhysObjectType::CAT_DOWN);
+		//checkFor |= PhysObjectType::mask(PhysObjectType::OBSTACLE_DOWN);
 	}
 
 	auto p1 = GetEntity()->transform;
@@ -34,8 +35,8 @@ bool Swords::use(Mouse* m) {
 	auto bl = pos + glm::vec3(-RADIUS, 0, -RADIUS);
 	auto tr = pos + glm::vec3(RADIUS, 0, RADIUS);
 
-	auto hits = _phys->areaCheck(checkFor, new Vector2D(bl.x, bl.z), new Vector2D(tr.x, tr.z));
-	bool hit = hits.size() > 0;
+	PhysicsComponent* hits[1];
+	bool hit = _phys->areaQuery(checkFor, Vector2D(bl.x, bl.z), Vector2D(tr.x, tr.z), hits, 1) > 0;
 
 	if (isUp && !_collidedObjects && hit) {
 		/**
@@ -22,7 +22,6 @@ private:
 	const int DAMAGE = 3;
 	PhysicsComponent* _phys;
 	PhysicsComponent* _collidedObjects;
-	std::set<PhysObjectType::PhysObjectType> checkFor;
 	Handler<Swords, PhysicsComponent*> HandleOnCollision;
 
 	static Component* Create(json json);
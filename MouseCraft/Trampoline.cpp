@@ -27,7 +27,7 @@ bool Trampoline::use(Mouse* m) {
 	_isPlaced = true;
 
 	auto ctype = up ? PhysObjectType::MOUSE_UP : PhysObjectType::MOUSE_DOWN;
-	checkFor.insert(ctype);
+	checkFor = PhysObjectType::mask(ctype);
 
 	GetEntity()->AddComponent(c_physics);
 
@@ -55,15 +55,16 @@ void Trampoline::Update(float dt) {
 	auto bl = glm::vec2(pos.x, pos.z) + glm::vec2(-1, -1);
 	auto tr = glm::vec2(pos.x, pos.z) + glm::vec2(1, 1);
 
-	auto hits = PhysicsManager::instance()->areaCheck(nullptr, checkFor, new Vector2D(bl), new Vector2D(tr));
-	bool hitMice = hits.size() > 0;
+	PhysicsComponent* hits[MAX_QUERY_RESULTS];
+	size_t hitCount = PhysicsManager::instance()->areaQuery(checkFor, Vector2D(bl), Vector2D(tr), hits, MAX_QUERY_RESULTS);
+	bool hitMice = hitCount > 0;
 
-	if (hits.size() > 0)
+	if (hitCount > 0)
 	{
 		//for now i'm just going to destroy the trampoline after 1 jump
 		std::cout << "Mouse touched trampoline" << std::endl;
 		
-		for (int i = 0; i < hits.size(); i++)
+		for (size_t i = 0; i < hitCount; i++)
 		{
 			hits[i]->GetEntity()->GetComponent<PhysicsComponent>()->onBounce.Notify(GetEntity()->GetComponent<PhysicsComponent>());
 		}
@@ -20,7 +20,7 @@ public:
 
 private: 
 	bool _isPlaced = false;
-	std::set<PhysObjectType::PhysObjectType> checkFor;
+	PhysObjectType::PhysObjectMask checkFor = 0;
 	Handler<Trampoline, PhysicsComponent*> HandleOnCollision;
 
 	static Component* Create(json json);
@@ -15,9 +15,10 @@ std::string ImageComponent::GetImagePath() {
 
 void ImageComponent::SetImagePath(std::string path) {
 	_imagePath = path;
+	valid = false;
 }
 
 void ImageComponent::setupModels() {
 	UIComponent::setupModels();
-	models[0]->setTexture(new std::string(_imagePath));
+	models[0]->setTexture(&_imagePath);
 }
\ No newline at end of file
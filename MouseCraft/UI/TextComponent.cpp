@@ -4,9 +4,10 @@
 const std::string TextComponent::DEFAULT_FONT = "res/fonts/ShareTechMono.png";
 
 TextComponent::TextComponent(std::string text, float fontSize, float x, float y, std::string fontPath) :
-    UIComponent(0, 0, x, y), _text(text), _fontSize(fontSize), _spacing(1.0f), _fontPath(fontPath) {
+    UIComponent(0, 0, x, y), _text(text), _fontSize(fontSize), _spacing(1.0f), _fontPath(fontPath), _glyphs(nullptr) {
 }
 
+
 void TextComponent::SetText(std::string text) {
     if (text != _text) { // If text is different, invalidate this UIComponent to be Resized
         _text = text;
@@ -69,50 +70,61 @@ void TextComponent::generateVertices() {
     glm::vec2 uv;
     //float fontWidth = screenSize.y * texture.width / texture.height;
 	float fontWidth = screenSize.y * _spacing;
-
-	models.clear();
-
+	float halfWidth = fontWidth / 2.0f;
+	float halfHeight = screenSize.y / 2.0f;
+
+	std::vector<GLfloat> vertices;
+	std::vector<GLfloat> normals;
+	std::vector<GLfloat> texCoords;
+	std::vector<GLuint> indices;
+	vertices.reserve(_text.length() * 12);
+	normals.reserve(_text.length() * 12);
+	texCoords.reserve(_text.length() * 8);
+	indices.reserve(_text.length() * 6);
+
+	// Glyph quads laid out the same as ModelGen::makeQuad, offset along x by their index
     for (int i = 0; i < _text.length(); i++) {
-		/*
-		positions.push_back(glm::vec3(screenPosition.x + fontWidth * i, screenPosition.y + screenSize.y, 0)); // Top Left
-		positions.push_back(glm::vec3(screenPosition.x + fontWidth * i + fontWidth, screenPosition.y + screenSize.y, 0)); // Top Right
-		positions.push_back(glm::vec3(screenPosition.x + fontWidth * i, screenPosition.y, 0)); // Bottom Left
-		positions.push_back(glm::vec3(screenPosition.x + fontWidth * i + fontWidth, screenPosition.y, 0)); // Bottom Right
-		
-		UVs.push_back(uv);
-		UVs.push_back(uv + glm::vec2(0.1, 0));
-		UVs.push_back(uv + glm::vec2(0, -0.1));
-		UVs.push_back(uv + glm::vec2(0.1, -0.1));
-
-		elements.push_back(i * 4 + 1);
-		elements.push_back(i * 4 + 0);
-		elements.push_back(i * 4 + 2);
-		elements.push_back(i * 4 + 1);
-		elements.push_back(i * 4 + 2);
-		elements.push_back(i * 4 + 3);
-		*/
-		Model* m = ModelGen::makeQuad(ModelGen::Axis::Z, fontWidth, screenSize.y);
-		auto& vec = m->getGeometry()->getVertexData();
-		for (int j = 0; j < vec.size(); j += 3) {
-			vec[j] += fontWidth * i;
+		float left = fontWidth * i - halfWidth;
+		float right = left + fontWidth;
+		GLfloat quad[] = {
+			left, -halfHeight, 0,
+			right, -halfHeight, 0,
+			left, halfHeight, 0,
+			right, halfHeight, 0
+		};
+		vertices.insert(vertices.end(), quad, quad + 12);
+		for (int j = 0; j < 4; j++) {
+			normals.push_back(0);
+			normals.push_back(0);
+			normals.push_back(1);
 		}
 
 		uv = getUVfromChar(_text[i]);
-		auto& uvs = m->getGeometry()->getTexCoordData();
-		uvs[0] = uv.x;
-		uvs[1] = uv.y - 0.1;
-		uvs[2] = uv.x + 0.1;
-		uvs[3] = uv.y - 0.1;
-		uvs[4] = uv.x;
-		uvs[5] = uv.y;
-		uvs[6] = uv.x + 0.1;
-		uvs[7] = uv.y;
-
-		m->setTexture(new std::string(_fontPath));
-
-		models.push_back(m);
+		GLfloat uvs[] = {
+			uv.x, uv.y - 0.1f,
+			uv.x + 0.1f, uv.y - 0.1f,
+			uv.x, uv.y,
+			uv.x + 0.1f, uv.y
+		};
+		texCoords.insert(texCoords.end(), uvs, uvs + 8);
+
+		GLuint base = i * 4;
+		GLuint quadIndices[] = {
+			base, base + 1, base + 3,
+			base, base + 3, base + 2
+		};
+		indices.insert(indices.end(), quadIndices, quadIndices + 6);
     }
 
+	if (_glyphs == nullptr) {
+		_glyphs = new Geometry();
+		models.push_back(new Model(_glyphs, &_fontPath));
+	}
+	_glyphs->setVertexData(vertices);
+	_glyphs->setNormalData(normals);
+	_glyphs->setTexCoordData(texCoords);
+	_glyphs->setIndices(indices);
+
 	// Shenanigans to set the position independent of parent location
 	// This is fine since the parents are resized first
 	glm::vec3 parentPos = { 0.0f, 0.0f, 0.0f };
@@ -28,4 +28,8 @@ private:
     float       _fontSize;
 	float		_spacing;
 	std::string	_fontPath;
+
+	// Every glyph is a quad in this one geometry, textured with _fontPath.
+	// Owned through models like any other panel geometry.
+	Geometry*	_glyphs;
 };
\ No newline at end of file
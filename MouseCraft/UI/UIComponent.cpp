@@ -7,7 +7,8 @@ UIComponent::UIComponent(float width, float height, float x, float y) :
     // Set default values for a panel
 	id = "";
     visible = true;
-	valid = true;
+	// Not laid out yet
+	valid = false;
     vAnchor = ANCHOR_TOP;
     hAnchor = ANCHOR_LEFT;
     anchorXType = ANCHOR_PIXEL;
@@ -27,7 +28,9 @@ UIComponent::UIComponent(float width, float height, float x, float y) :
 }
 
 UIComponent::~UIComponent() {
+	// Panels own their models and geometry
 	for (Model* model : models) {
+		delete model->getGeometry();
 		delete model;
 	}
 }
@@ -84,8 +87,13 @@ void UIComponent::Resize() {
 }
 
 void UIComponent::setupModels() {
-	models.clear();
-	models.push_back(ModelGen::makeQuad(ModelGen::Axis::Z, screenSize.x, screenSize.y));
+	// Reuse the quad from the last layout
+	if (models.empty()) {
+		models.push_back(ModelGen::makeQuad(ModelGen::Axis::Z, screenSize.x, screenSize.y));
+	}
+	else {
+		ModelGen::resizeQuad(models[0], ModelGen::Axis::Z, screenSize.x, screenSize.y);
+	}
 
 	// Shenanigans to set the position independent of parent location
 	// This is fine since the parents are resized first
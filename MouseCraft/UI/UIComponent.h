@@ -49,7 +49,8 @@ public:
 	// Whether or not this UIComponent and its children should be drawn
     bool                visible;
 
-	// UIComponent should be resized if Valid is set to false
+	// UIComponent should be resized if Valid is set to false.
+	// Set this after changing any layout field, UIManager only lays out invalid panels and their children.
 	bool				valid;
 
 	Color				color;
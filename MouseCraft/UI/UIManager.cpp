@@ -9,24 +9,25 @@ using std::vector;
 UIManager::UIManager(){}
 
 void UIManager::Update(float dt) {
-	vector<UIComponent*> rootComponents;
-	
-	auto uiComponents = ComponentManager<UIComponent>::Instance().All();
-	for (auto component : uiComponents) {
-		Entity* e = component->GetEntity();
-		if (e != nullptr) {
-			Entity* parent = e->GetParent();
-			if (parent == nullptr || parent->GetComponent<UIComponent>() == nullptr) {
-				// If the entity doesn't have a parent or has a parent that doesn't have a UIComponent
-				// Then it is a root entity
-				rootComponents.push_back(component);
-			}
+	// Only lay out panels that were invalidated. Resizing a panel resizes its children,
+	// so start from the highest invalid ancestor to lay each subtree out once.
+	const auto& uiComponents = ComponentManager<UIComponent>::Instance().All();
+	for (UIComponent* component : uiComponents) {
+		if (component->valid || component->GetEntity() == nullptr) continue;
+
+		UIComponent* top = component;
+		UIComponent* parent = getParentUI(top);
+		while (parent != nullptr && !parent->valid) {
+			top = parent;
+			parent = getParentUI(top);
 		}
+		Resize(top);
 	}
+}
 
-	for (UIComponent* component : rootComponents) {
-		Resize(component);
-	}
+UIComponent* UIManager::getParentUI(UIComponent* component) {
+	Entity* parent = component->GetEntity()->GetParent();
+	return parent != nullptr ? parent->GetComponent<UIComponent>() : nullptr;
 }
 
 void UIManager::Resize(UIComponent* root) {
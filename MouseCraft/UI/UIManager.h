@@ -32,6 +32,9 @@ private:
 	// Find the top element under your cursor that has an on-click event and store it in the top pointer location
 	void findTopClick(UIComponent** top, UIComponent* comp, const float x, const float y);
 
+	// The UIComponent of the panel's parent entity, nullptr for a root panel
+	UIComponent* getParentUI(UIComponent* component);
+
 	// Is the given point in the defined rectangle
     bool pointInRect(float px, float py, float rTop, float rRight, float rLeft, float rBottom);
 
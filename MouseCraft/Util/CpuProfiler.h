@@ -8,6 +8,7 @@
 #include <iostream>
 #include <iomanip>
 #include <locale>
+#include <algorithm>
 
 // A helper class to measure CPU performance. 
 // To measure GPU performance use OpenGLProfiler.
@@ -18,6 +19,7 @@ class CpuProfiler
 private:
 	std::vector<clk::time_point> timeStamps;
 	std::vector<clk::duration> durations;
+	std::vector<long long> counters;
 	std::ofstream file;
 	std::stringstream stream;
 	bool createOutput = false;			// whether or not to generate a formatted string.
@@ -59,6 +61,25 @@ public:
 		durations[timer] = clk::now() - timeStamps[timer];
 	}
 
+	// Creates count amount of counters for per-frame totals such as draw calls.
+	// Counters are 0 based and reset by FrameFinish.
+	void InitializeCounters(unsigned int count)
+	{
+		counters.assign(count, 0);
+	}
+
+	// Add to a counter for this frame. Counter's are 0 based.
+	void AddToCounter(unsigned int counter, long long amount = 1)
+	{
+		counters[counter] += amount;
+	}
+
+	// Gets the current frame's total for a counter. Counter's are 0 based.
+	long long GetCounter(unsigned int counter)
+	{
+		return counters[counter];
+	}
+
 	// Gets the duration for a timer in nanoseconds. Timer's are 0 based.
 	long long GetDuration(unsigned int timer)
 	{
@@ -91,6 +112,10 @@ public:
 				else
 					stream << "   [" << i << "]: " << GetDuration(i);
 			}
+			for (size_t i = 0; i < counters.size(); i++)
+			{
+				stream << "   <" << i << ">: " << counters[i];
+			}
 			if (printingOutput)
 			{
 				if (printingOutputFlushed)
@@ -103,6 +128,7 @@ public:
 				file << stream.str() << std::endl;
 			}
 		}
+		std::fill(counters.begin(), counters.end(), 0);
 	}
 
 #pragma region Logging functions 
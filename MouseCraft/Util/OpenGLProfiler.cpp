@@ -8,4 +8,6 @@ OpenGLProfiler::OpenGLProfiler()
 
 OpenGLProfiler::~OpenGLProfiler()
 {
+	if (queries.size() > 0)
+		glDeleteQueries(queries.size(), &queries[0]);
 }
@@ -10,12 +10,20 @@ class OpenGLProfiler
 // variables 
 private:
 	std::vector<GLuint> queries;		// stores all the opengl queries
+	std::vector<unsigned int> issued;	// frame + 1 each query was last issued in, 0 if never.
 	unsigned int queryBackBuffer = 0;	// determines which set of queries to use. 
+	unsigned int frame = 0;
 
 // functions 
 public:
 	OpenGLProfiler();
 	~OpenGLProfiler();
+
+	// Whether the current context can record timestamps (core since OpenGL 3.3).
+	static bool IsSupported()
+	{
+		return GLAD_GL_VERSION_3_3 || GLAD_GL_ARB_timer_query;
+	}
 	
 	// Creates count amount of timers to measure OpenGL commands. 
 	// Calling this function clears any previous timers.
@@ -28,6 +36,7 @@ public:
 		// for each timer we need to create 4 opengl queries 
 		// (1 for start, 1 for end) x2 for back buffering 
 		queries.resize(count * 4);
+		issued.assign(count * 4, 0);
 		if (count > 0) 
 			glGenQueries(count * 4, &queries[0]);
 	}
@@ -37,6 +46,7 @@ public:
 	{
 		auto index = GetIndex(timer);
 		glQueryCounter(queries[index], GL_TIMESTAMP);
+		issued[index] = frame + 1;
 	}
 	
 	// Stop measuring duration for a specified timer. Timer's are 0 based.
@@ -44,6 +54,7 @@ public:
 	{
 		auto index = GetIndex(timer);
 		glQueryCounter(queries[index + 1], GL_TIMESTAMP);
+		issued[index + 1] = frame + 1;
 	}
 
 	// Call this after starting/stopping all your timers for the frame.
@@ -53,9 +64,22 @@ public:
 			queryBackBuffer = 0;
 		else
 			queryBackBuffer = 1;
+		++frame;
+	}
+
+	// Whether a timer ran last frame and its duration can be read without stalling.
+	// Call after FrameFinish. Timer's are 0 based.
+	bool IsReady(unsigned int timer)
+	{
+		auto index = GetIndex(timer);
+		if (issued[index] == 0 || issued[index] != frame - 1 || issued[index + 1] != frame - 1)
+			return false;
+		GLint available = 0;
+		glGetQueryObjectiv(queries[index + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		return available != 0;
 	}
 	
-	// Gets the duration for a timer in nanoseconds. Timer's are 0 based.
+	// Gets last frame's duration for a timer in nanoseconds. Timer's are 0 based.
 	GLuint64 GetDuration(unsigned int timer)
 	{
 		auto index = GetIndex(timer);
@@ -20,9 +20,9 @@ void Vase::OnInitialized()
 {
 	auto physics = GetEntity()->GetComponent<PhysicsComponent>();
 	if (physics->isUp)
-		_checkFor = { PhysObjectType::MOUSE_UP };
+		_checkFor = PhysObjectType::mask(PhysObjectType::MOUSE_UP);
 	else
-		_checkFor = { PhysObjectType::MOUSE_DOWN };
+		_checkFor = PhysObjectType::mask(PhysObjectType::MOUSE_DOWN);
 }
 
 void Vase::Update(float deltaTime)
@@ -32,10 +32,12 @@ void Vase::Update(float deltaTime)
 		auto pos = GetEntity()->t().wPos();
 		auto bl = pos + glm::vec3(-0.5, 0, -0.5) * FIELD_RANGE;
 		auto tr = pos + glm::vec3(0.5, 0, 0.5) * FIELD_RANGE;
-		auto hits = PhysicsManager::instance()->areaCheck(nullptr, _checkFor, new Vector2D(bl.x, bl.z), new Vector2D(tr.x, tr.z));
+		PhysicsComponent* hits[MAX_QUERY_RESULTS];
+		size_t hitCount = PhysicsManager::instance()->areaQuery(_checkFor, Vector2D(bl.x, bl.z), Vector2D(tr.x, tr.z), hits, MAX_QUERY_RESULTS);
 
-		for (auto& p : hits)
+		for (size_t i = 0; i < hitCount; i++)
 		{
+			PhysicsComponent* p = hits[i];
 			auto it = std::find(_affected.begin(), _affected.end(), p);
 			if (it == _affected.end())
 			{
@@ -46,12 +48,12 @@ void Vase::Update(float deltaTime)
 		_found.clear();
 		for (auto p : _affected)
 		{
-			if (hits.size() != 0)
+			if (hitCount != 0)
 			{
-				auto it = std::find(hits.begin(), hits.end(), p);
-				if (it == hits.end())
+				auto it = std::find(hits, hits + hitCount, p);
+				if (it == hits + hitCount)
 				{
-					_found.push_back(*it);
+					_found.push_back(p);
 				}
 			}
 			else
@@ -31,7 +31,7 @@ private:
 	bool _isPlaced = false;
 
 	// the floor which to check the cat for
-	std::set<PhysObjectType::PhysObjectType> _checkFor;
+	PhysObjectType::PhysObjectMask _checkFor = 0;
 
 	float _counter = 0;
 
@@ -1,26 +1,23 @@
 #include "WorldGrid.h"
 
+#include <utility>
+
 //Make sure scale (s) divides into both the width and height otherwise the grid won't be as big as you intend
 WorldGrid::WorldGrid(int w, int h, int s)
 {
 	scale = s;
-	int gridW = w / scale;
-	int gridH = h / scale;
-	baseGrid = std::vector<std::vector<bool>>(gridW);
-	objectGrid = std::vector<std::vector<PhysicsComponent*>>(gridW);
+	gridW = w / scale;
+	gridH = h / scale;
+	rowWords = (gridW + 63) / 64;
 
-	//Their default values should be NOTHING since it's at index 0 of the enum (I think)
-	for (int i = 0; i < gridW; i++)
-	{
-		baseGrid[i] = std::vector<bool>(gridH);
-		objectGrid[i] = std::vector<PhysicsComponent*>(gridH);
-	}
+	objectGrid = std::vector<PhysicsComponent*>(gridW * gridH, nullptr);
+	layers = std::vector<uint64_t>(LAYER_COUNT * gridH * rowWords, 0);
 }
 
 WorldGrid::~WorldGrid()
 {
-	baseGrid.clear();
 	objectGrid.clear();
+	layers.clear();
 }
 
 //Corrects the positions to ensure they're in the grid
@@ -32,14 +29,15 @@ bool WorldGrid::positionObject(Vector2D& pos)
 
 	if (xInd < 0)
 		xInd = 0;
-	else if (xInd >= baseGrid.size())
-		xInd = baseGrid.size() - 1;
-	else if (yInd < 0)
+	else if (xInd >= gridW)
+		xInd = gridW - 1;
+
+	if (yInd < 0)
 		yInd = 0;
-	else if (yInd >= baseGrid[0].size())
-		yInd = baseGrid[0].size() - 1;
+	else if (yInd >= gridH)
+		yInd = gridH - 1;
 
-	if (objectGrid[xInd][yInd] != nullptr)
+	if (testTile(OCCUPIED_LAYER, xInd, yInd))
 		return false;
 
 	pos.x = xInd * scale;
@@ -48,182 +46,324 @@ bool WorldGrid::positionObject(Vector2D& pos)
 	return true;
 }
 
+//Corrects the corners to the grid, p1 becomes the corner with the lower x and higher y
 //Returns false if there is something already there
 bool WorldGrid::positionArea(Vector2D& p1, Vector2D& p2)
 {
-	int x1 = round(p1.x / scale);
-	int x2 = round(p2.x / scale);
-	int y1 = round(p1.y / scale);
-	int y2 = round(p2.y / scale);
+	int x1, y1, x2, y2;
+	areaTiles(p1, p2, x1, y1, x2, y2);
+	clampRect(x1, y1, x2, y2);
 
-	//Fix the points if the user input them in the wrong order or something
-	if (x1 > x2)
-	{
-		int temp = x1;
-		x1 = x2;
-		x2 = temp;
-	}
-
-	if (y2 > y1)
-	{
-		int temp = y2;
-		y2 = y1;
-		y1 = temp;
-	}
-
-	if (x1 < 0)
-		x1 = 0;
-	else if (x1 > baseGrid.size())
-		x1 = baseGrid.size();
-	else if (y1 < 0)
-		y1 = 0;
-	else if (y1 > baseGrid[0].size())
-		y1 = baseGrid[0].size();
-	else if (x2 < 0)
-		x2 = 0;
-	else if (x2 > baseGrid.size())
-		x2 = baseGrid.size();
-	else if (y2 < 0)
-		y2 = 0;
-	else if (y2 > baseGrid[0].size())
-		y2 = baseGrid[0].size();
-
-	for (int x = x1; x < x2; x++)
-	{
-		for (int y = y1; y < y2; y++)
-		{
-			if (objectGrid[x][y] != nullptr)
-				return false;
-		}
-	}
+	if (testRect(OCCUPIED_LAYER, x1, y1, x2, y2))
+		return false;
 
 	p1.x = x1 * scale;
-	p1.y = y1 * scale;
+	p1.y = y2 * scale;
 	p2.x = x2 * scale;
-	p2.y = y2 * scale;
+	p2.y = y1 * scale;
 
 	return true;
 }
 
-//Corrects the positions to ensure they're in the grid then puts the object there
-//Returns false if there is something already there
+//Puts the object at the position if nothing is there yet
 void WorldGrid::createObject(Vector2D& pos, PhysicsComponent* pcomp)
 {
 	int xInd = round(pos.x / scale);
 	int yInd = round(pos.y / scale);
 
-	if (objectGrid[xInd][yInd] != nullptr)
-		objectGrid[xInd][yInd] = pcomp;
+	if (!inGrid(xInd, yInd) || objectGrid[yInd * gridW + xInd] != nullptr)
+		return;
+
+	objectGrid[yInd * gridW + xInd] = pcomp;
+	fillRect(OCCUPIED_LAYER, xInd, yInd, xInd + 1, yInd + 1);
 }
 
-//Returns false if there is something already there
+//Puts the object in every empty tile of the area
 void WorldGrid::createArea(Vector2D& p1, Vector2D& p2, PhysicsComponent* pcomp)
 {
-	int x1 = round(p1.x / scale);
-	int x2 = round(p2.x / scale);
-	int y1 = round(p1.y / scale);
-	int y2 = round(p2.y / scale);
+	int x1, y1, x2, y2;
+	areaTiles(p1, p2, x1, y1, x2, y2);
 
-	for (int x = x1; x < x2; x++)
+	if (!clampRect(x1, y1, x2, y2))
+		return;
+
+	for (int y = y1; y < y2; y++)
 	{
-		for (int y = y1; y < y2; y++)
+		for (int x = x1; x < x2; x++)
 		{
-			if (objectGrid[x][y] != nullptr)
-				objectGrid[x][y] = pcomp;
+			if (objectGrid[y * gridW + x] == nullptr)
+				objectGrid[y * gridW + x] = pcomp;
 		}
 	}
+
+	fillRect(OCCUPIED_LAYER, x1, y1, x2, y2);
 }
 
+//Returns true if there was something to remove
 bool WorldGrid::removeObject(float xPos, float yPos)
 {
 	int xInd = round(xPos / scale);
 	int yInd = round(yPos / scale);
 
-	if (xInd >= 0 && xInd < baseGrid.size() && yInd >= 0 && yInd < baseGrid[0].size())
-		objectGrid[xInd][yInd] = nullptr;
+	if (!inGrid(xInd, yInd) || objectGrid[yInd * gridW + xInd] == nullptr)
+		return false;
 
-	return false;
+	objectGrid[yInd * gridW + xInd] = nullptr;
+	clearRect(OCCUPIED_LAYER, xInd, yInd, xInd + 1, yInd + 1);
+
+	return true;
 }
 
-bool WorldGrid::removeArea(Vector2D* p1, Vector2D* p2)
+//Empties every tile of the area, returns false if the area is outside the grid
+bool WorldGrid::removeArea(Vector2D& p1, Vector2D& p2)
 {
-	int x1 = p1->x;
-	int x2 = p2->x;
-	int y1 = p1->y;
-	int y2 = p2->y;
+	int x1, y1, x2, y2;
+	areaTiles(p1, p2, x1, y1, x2, y2);
 
-	if (x1 >= 0 && x1 < baseGrid.size() && y1 >= 0 && y1 < baseGrid[0].size()
-		&& x2 >= 0 && x2 < baseGrid.size() && y2 >= 0 && y2 < baseGrid[0].size())
-	{
-		//Fix the points if the user input them in the wrong order or something
-		if (x1 > x2)
-		{
-			int temp = x1;
-			x1 = x2;
-			x2 = temp;
-		}
+	if (!clampRect(x1, y1, x2, y2))
+		return false;
 
-		if (y2 > y1)
-		{
-			int temp = y2;
-			y2 = y1;
-			y1 = temp;
-		}
+	setObjects(x1, y1, x2, y2, nullptr);
+	clearRect(OCCUPIED_LAYER, x1, y1, x2, y2);
 
-		for (int x = x1; x <= x2; x++)
+	return true;
+}
+
+//Empties the tiles around the area that hold this object, leaving anything else placed nearby
+//The area is searched a tile further out on each side, since objects are snapped to the grid when placed
+void WorldGrid::removeComponent(PhysicsComponent* pcomp, float x1, float y1, float x2, float y2)
+{
+	int tx1, ty1, tx2, ty2;
+	areaTiles(Vector2D(x1, y1), Vector2D(x2, y2), tx1, ty1, tx2, ty2);
+
+	//Order the corners before widening, or a flipped area would shrink instead
+	if (tx1 > tx2)
+		std::swap(tx1, tx2);
+	if (ty1 > ty2)
+		std::swap(ty1, ty2);
+
+	tx1--;
+	ty1--;
+	tx2++;
+	ty2++;
+
+	if (!clampRect(tx1, ty1, tx2, ty2))
+		return;
+
+	for (int y = ty1; y < ty2; y++)
+	{
+		for (int x = tx1; x < tx2; x++)
 		{
-			for (int y = y1; y <= y2; y++)
+			if (objectGrid[y * gridW + x] == pcomp)
 			{
-				objectGrid[x][y] = nullptr;
+				objectGrid[y * gridW + x] = nullptr;
+				clearRect(OCCUPIED_LAYER, x, y, x + 1, y + 1);
 			}
 		}
-
-		return true;
 	}
-
-	return false;
 }
 
 PhysicsComponent* WorldGrid::objectAt(float xPos, float yPos)
 {
-	int xInd = round(xPos / scale);
-	int yInd = round(yPos / scale);
+	return objectAt((int)round(xPos / scale), (int)round(yPos / scale));
+}
 
-	if (xInd >= 0 && xInd < baseGrid.size() && yInd >= 0 && yInd < baseGrid[0].size())
-		return objectGrid[xInd][yInd];
+PhysicsComponent* WorldGrid::objectAt(int xPos, int yPos)
+{
+	if (inGrid(xPos, yPos))
+		return objectGrid[yPos * gridW + xPos];
 
 	return nullptr;
 }
 
-PhysicsComponent* WorldGrid::objectAt(int xPos, int yPos)
+bool WorldGrid::tileIsUp(float xPos, float yPos)
 {
-	if (xPos >= 0 && xPos < baseGrid.size() && yPos >= 0 && yPos < baseGrid[0].size())
-		return objectGrid[xPos][yPos];
+	return tileIsUp((int)round(xPos / scale), (int)round(yPos / scale));
 }
 
-bool WorldGrid::tileIsUp(float xPos, float yPos)
+bool WorldGrid::tileIsUp(int xPos, int yPos)
 {
-	int xInd = round(xPos / scale);
-	int yInd = round(yPos / scale);
+	return testTile(UP_LAYER, xPos, yPos);
+}
+
+//Marks the tiles under a platform so falling can be checked without querying the physics world
+//Corners are in world units, the area must not overlap another platform
+void WorldGrid::addPlatform(float x1, float y1, float x2, float y2)
+{
+	int tx1, tx2, ty1, ty2;
 
-	if (xInd >= 0 && xInd < baseGrid.size() && yInd >= 0 && yInd < baseGrid[0].size())
-		return baseGrid[xInd][yInd];
+	if (tileRange(fmin(x1, x2), fmax(x1, x2), gridW, tx1, tx2)
+		&& tileRange(fmin(y1, y2), fmax(y1, y2), gridH, ty1, ty2))
+		fillRect(PLATFORM_LAYER, tx1, ty1, tx2 + 1, ty2 + 1);
+}
 
-	return false;
+void WorldGrid::removePlatform(float x1, float y1, float x2, float y2)
+{
+	int tx1, tx2, ty1, ty2;
+
+	if (tileRange(fmin(x1, x2), fmax(x1, x2), gridW, tx1, tx2)
+		&& tileRange(fmin(y1, y2), fmax(y1, y2), gridH, ty1, ty2))
+		clearRect(PLATFORM_LAYER, tx1, ty1, tx2 + 1, ty2 + 1);
 }
 
-bool WorldGrid::tileIsUp(int xPos, int yPos)
+//Returns true if any tile the area covers is under a platform
+bool WorldGrid::platformInArea(float x1, float y1, float x2, float y2)
 {
-	if (xPos >= 0 && xPos < baseGrid.size() && yPos >= 0 && yPos < baseGrid[0].size())
-		return baseGrid[xPos][yPos];
+	int tx1, tx2, ty1, ty2;
+
+	if (!tileRange(fmin(x1, x2), fmax(x1, x2), gridW, tx1, tx2)
+		|| !tileRange(fmin(y1, y2), fmax(y1, y2), gridH, ty1, ty2))
+		return false;
+
+	return testRect(PLATFORM_LAYER, tx1, ty1, tx2 + 1, ty2 + 1);
 }
 
 int WorldGrid::gridWidth()
 {
-	return baseGrid.size();
+	return gridW;
 }
 
 int WorldGrid::gridHeight()
 {
-	return baseGrid[0].size();
+	return gridH;
+}
+
+void WorldGrid::fillRect(GridLayer layer, int x1, int y1, int x2, int y2)
+{
+	applyRect(layer, x1, y1, x2, y2, FILL);
+}
+
+void WorldGrid::clearRect(GridLayer layer, int x1, int y1, int x2, int y2)
+{
+	applyRect(layer, x1, y1, x2, y2, CLEAR);
+}
+
+//Returns true if any tile in the rectangle is set
+bool WorldGrid::testRect(GridLayer layer, int x1, int y1, int x2, int y2)
+{
+	return applyRect(layer, x1, y1, x2, y2, TEST);
+}
+
+bool WorldGrid::testTile(GridLayer layer, int x, int y)
+{
+	if (!inGrid(x, y))
+		return false;
+
+	uint64_t word = layers[(layer * gridH + y) * rowWords + (x >> 6)];
+	return (word >> (x & 63)) & 1;
+}
+
+bool WorldGrid::inGrid(int x, int y)
+{
+	return x >= 0 && x < gridW && y >= 0 && y < gridH;
+}
+
+//Puts the corners in order and clamps each of them to the grid
+//Returns false if nothing is left of the rectangle
+bool WorldGrid::clampRect(int& x1, int& y1, int& x2, int& y2)
+{
+	if (x1 > x2)
+	{
+		int temp = x1;
+		x1 = x2;
+		x2 = temp;
+	}
+
+	if (y1 > y2)
+	{
+		int temp = y1;
+		y1 = y2;
+		y2 = temp;
+	}
+
+	x1 = x1 < 0 ? 0 : (x1 > gridW ? gridW : x1);
+	x2 = x2 < 0 ? 0 : (x2 > gridW ? gridW : x2);
+	y1 = y1 < 0 ? 0 : (y1 > gridH ? gridH : y1);
+	y2 = y2 < 0 ? 0 : (y2 > gridH ? gridH : y2);
+
+	return x1 < x2 && y1 < y2;
+}
+
+//Converts two corners in world units to the tiles between them, in the order they were given
+void WorldGrid::areaTiles(const Vector2D& p1, const Vector2D& p2, int& x1, int& y1, int& x2, int& y2)
+{
+	x1 = round(p1.x / scale);
+	y1 = round(p1.y / scale);
+	x2 = round(p2.x / scale);
+	y2 = round(p2.y / scale);
+}
+
+//Finds the tiles a span in world units covers, clamped to the grid
+//Returns false if the span is entirely outside it
+bool WorldGrid::tileRange(float lo, float hi, int count, int& first, int& last)
+{
+	first = (int)floor(lo / scale);
+	last = (int)ceil(hi / scale) - 1;
+
+	//A span that doesn't reach past a tile edge still covers the tile it's in
+	if (last < first)
+		last = first;
+
+	if (last < 0 || first >= count)
+		return false;
+
+	if (first < 0)
+		first = 0;
+	if (last >= count)
+		last = count - 1;
+
+	return true;
+}
+
+//Applies the operation to whole words of each row, masking off the tiles outside the rectangle at either end
+bool WorldGrid::applyRect(GridLayer layer, int x1, int y1, int x2, int y2, RectOp op)
+{
+	if (!clampRect(x1, y1, x2, y2))
+		return false;
+
+	int firstWord = x1 >> 6;
+	int lastWord = (x2 - 1) >> 6;
+	uint64_t firstMask = ~0ull << (x1 & 63);
+	uint64_t lastMask = ~0ull >> (63 - ((x2 - 1) & 63));
+
+	for (int y = y1; y < y2; y++)
+	{
+		uint64_t* row = &layers[(layer * gridH + y) * rowWords];
+
+		for (int w = firstWord; w <= lastWord; w++)
+		{
+			uint64_t mask = ~0ull;
+			if (w == firstWord)
+				mask &= firstMask;
+			if (w == lastWord)
+				mask &= lastMask;
+
+			switch (op)
+			{
+			case FILL:
+				row[w] |= mask;
+				break;
+			case CLEAR:
+				row[w] &= ~mask;
+				break;
+			case TEST:
+				if (row[w] & mask)
+					return true;
+				break;
+			}
+		}
+	}
+
+	return false;
+}
+
+void WorldGrid::setObjects(int x1, int y1, int x2, int y2, PhysicsComponent* pcomp)
+{
+	for (int y = y1; y < y2; y++)
+	{
+		for (int x = x1; x < x2; x++)
+		{
+			objectGrid[y * gridW + x] = pcomp;
+		}
+	}
 }
\ No newline at end of file
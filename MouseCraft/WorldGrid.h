@@ -1,10 +1,20 @@
 #pragma once
 #include <vector>
+#include <cstdint>
 #include <math.h>
 #include "Core\Vector2D.h"
 
 class PhysicsComponent;
 
+//Which tiles are covered by something, one bit per tile
+enum GridLayer
+{
+	OCCUPIED_LAYER, //an object or area has been placed there
+	PLATFORM_LAYER,
+	UP_LAYER,
+	LAYER_COUNT
+};
+
 class WorldGrid
 {
 public:
@@ -15,16 +25,47 @@ public:
 	void createObject(Vector2D& pos, PhysicsComponent* pcomp);
 	void createArea(Vector2D& p1, Vector2D& p2, PhysicsComponent* pcomp);
 	bool removeObject(float xPos, float yPos);
-	bool removeArea(Vector2D* p1, Vector2D* p2);
+	bool removeArea(Vector2D& p1, Vector2D& p2);
+	void removeComponent(PhysicsComponent* pcomp, float x1, float y1, float x2, float y2);
 	PhysicsComponent* objectAt(float xPos, float yPos);
 	PhysicsComponent* objectAt(int xPos, int yPos);
 	bool tileIsUp(float xPos, float yPos);
 	bool tileIsUp(int xPos, int yPos);
+	void addPlatform(float x1, float y1, float x2, float y2);
+	void removePlatform(float x1, float y1, float x2, float y2);
+	bool platformInArea(float x1, float y1, float x2, float y2);
 	int gridWidth();
 	int gridHeight();
 
+	//Rectangles are in tiles from (x1, y1) up to but not including (x2, y2), clamped to the grid
+	//They work on whole 64 bit words, so they cost one operation per 64 tiles of each row
+	void fillRect(GridLayer layer, int x1, int y1, int x2, int y2);
+	void clearRect(GridLayer layer, int x1, int y1, int x2, int y2);
+	bool testRect(GridLayer layer, int x1, int y1, int x2, int y2);
+	bool testTile(GridLayer layer, int x, int y);
+
 	int scale;
 private:
-	std::vector<std::vector<bool>> baseGrid;
-	std::vector<std::vector<PhysicsComponent*>> objectGrid;
+	enum RectOp
+	{
+		FILL,
+		CLEAR,
+		TEST
+	};
+
+	int gridW;
+	int gridH;
+	int rowWords; //64 bit words per row of a layer
+
+	//Row major, indexed y * gridW + x
+	std::vector<PhysicsComponent*> objectGrid;
+	//Every layer one after the other, each row starting on a new word
+	std::vector<uint64_t> layers;
+
+	bool inGrid(int x, int y);
+	bool clampRect(int& x1, int& y1, int& x2, int& y2);
+	void areaTiles(const Vector2D& p1, const Vector2D& p2, int& x1, int& y1, int& x2, int& y2);
+	bool tileRange(float lo, float hi, int count, int& first, int& last);
+	bool applyRect(GridLayer layer, int x1, int y1, int x2, int y2, RectOp op);
+	void setObjects(int x1, int y1, int x2, int y2, PhysicsComponent* pcomp);
 };
\ No newline at end of file
@@ -16,11 +16,11 @@ void YarnBall::OnInitialized()
 	Obstacle::OnInitialized();
 	_physics = GetEntity()->GetComponent<PhysicsComponent>();
 	_physics->onCollide.Attach(HandleMouseCollide);
+	_physics->checksFalling = true;
 }
 
 void YarnBall::Update(float deltaTime)
 {
-	_physics->updateFalling();
 }
 
 void YarnBall::HitByCat(Vector2D dir)
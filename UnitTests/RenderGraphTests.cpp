@@ -0,0 +1,171 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../MouseCraft/Graphics/RenderGraphSchedule.cpp"
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace RenderGraphTests {
+    // The same targets and passes GLRenderBackend declares
+    struct BackendGraph {
+        RenderGraphSchedule schedule;
+        int albedo, normal, position, depth, outline;
+        int gbufferPass, outlinePass, lightingPass, uiPass;
+
+        BackendGraph() {
+            albedo = schedule.addTarget(GL_RGBA16F);
+            normal = schedule.addTarget(GL_RGBA16F);
+            position = schedule.addTarget(GL_RGBA16F);
+            depth = schedule.addTarget(GL_DEPTH24_STENCIL8);
+            outline = schedule.addTarget(GL_RGBA16F);
+            gbufferPass = schedule.addPass({}, { albedo, normal, position, depth });
+            outlinePass = schedule.addPass({ depth }, { outline, depth });
+            lightingPass = schedule.addPass({ albedo, normal, position, outline }, { RenderGraphSchedule::BACKBUFFER });
+            uiPass = schedule.addPass({}, { RenderGraphSchedule::BACKBUFFER });
+            schedule.setBackbufferSize(64, 48);
+        }
+    };
+
+    TEST_CLASS(CullingTests) {
+    public:
+        TEST_METHOD(AllPassesActive) {
+            BackendGraph g;
+            g.schedule.compile();
+            Assert::IsTrue(g.schedule.isPassActive(g.gbufferPass));
+            Assert::IsTrue(g.schedule.isPassActive(g.outlinePass));
+            Assert::IsTrue(g.schedule.isPassActive(g.lightingPass));
+            Assert::IsTrue(g.schedule.isPassActive(g.uiPass));
+        }
+
+        TEST_METHOD(OutlineCulledWhenDisabled) {
+            BackendGraph g;
+            g.schedule.setPassEnabled(g.outlinePass, false);
+            g.schedule.compile();
+            Assert::IsFalse(g.schedule.isPassActive(g.outlinePass));
+            Assert::IsTrue(g.schedule.isPassActive(g.gbufferPass));
+            Assert::IsTrue(g.schedule.isPassActive(g.lightingPass));
+            Assert::AreEqual(g.schedule.getSlot(g.outline), -1);
+            // Depth is still written by the gbuffer, only up to the last pass that uses it
+            int first, last;
+            g.schedule.getLifetime(g.depth, first, last);
+            Assert::AreEqual(first, g.gbufferPass);
+            Assert::AreEqual(last, g.gbufferPass);
+        }
+
+        TEST_METHOD(SceneChainDroppedWithoutCamera) {
+            // Without a camera the frame records no scene, outlines or lighting, only UI
+            BackendGraph g;
+            g.schedule.setPassEnabled(g.gbufferPass, false);
+            g.schedule.setPassEnabled(g.outlinePass, false);
+            g.schedule.setPassEnabled(g.lightingPass, false);
+            g.schedule.compile();
+            Assert::IsFalse(g.schedule.isPassActive(g.gbufferPass));
+            Assert::IsFalse(g.schedule.isPassActive(g.outlinePass));
+            Assert::IsFalse(g.schedule.isPassActive(g.lightingPass));
+            Assert::IsTrue(g.schedule.isPassActive(g.uiPass));
+            Assert::AreEqual(g.schedule.getSlots().size(), (size_t)0);
+        }
+
+        TEST_METHOD(FeedersCulledWithoutLighting) {
+            // The gbuffer and outlines are enabled but nothing reads them
+            BackendGraph g;
+            g.schedule.setPassEnabled(g.lightingPass, false);
+            g.schedule.compile();
+            Assert::IsFalse(g.schedule.isPassActive(g.gbufferPass));
+            Assert::IsFalse(g.schedule.isPassActive(g.outlinePass));
+            Assert::IsTrue(g.schedule.isPassActive(g.uiPass));
+            Assert::AreEqual(g.schedule.getSlot(g.albedo), -1);
+            Assert::AreEqual(g.schedule.getSlot(g.depth), -1);
+        }
+
+        TEST_METHOD(UnreadPassCulled) {
+            RenderGraphSchedule s;
+            int a = s.addTarget(GL_RGBA16F);
+            int unused = s.addTarget(GL_RGBA16F);
+            int write = s.addPass({}, { a });
+            int dead = s.addPass({ a }, { unused });
+            int present = s.addPass({ a }, { RenderGraphSchedule::BACKBUFFER });
+            s.compile();
+            Assert::IsTrue(s.isPassActive(write));
+            Assert::IsFalse(s.isPassActive(dead));
+            Assert::IsTrue(s.isPassActive(present));
+            Assert::AreEqual(s.getSlot(unused), -1);
+        }
+    };
+
+    TEST_CLASS(AliasingTests) {
+    public:
+        TEST_METHOD(DisjointLifetimesShareSlot) {
+            // x is dead once y is written, so z can take its texture
+            RenderGraphSchedule s;
+            int x = s.addTarget(GL_RGBA16F);
+            int y = s.addTarget(GL_RGBA16F);
+            int z = s.addTarget(GL_RGBA16F);
+            s.addPass({}, { x });
+            s.addPass({ x }, { y });
+            s.addPass({ y }, { z });
+            s.addPass({ z }, { RenderGraphSchedule::BACKBUFFER });
+            s.setBackbufferSize(16, 16);
+            s.compile();
+            Assert::AreEqual(s.getSlot(x), s.getSlot(z));
+            Assert::AreNotEqual(s.getSlot(x), s.getSlot(y));
+            Assert::AreEqual(s.getSlots().size(), (size_t)2);
+        }
+
+        TEST_METHOD(OverlappingLifetimesDontShare) {
+            BackendGraph g;
+            g.schedule.compile();
+            // Every color target lives until lighting, so none of them alias
+            Assert::AreNotEqual(g.schedule.getSlot(g.albedo), g.schedule.getSlot(g.normal));
+            Assert::AreNotEqual(g.schedule.getSlot(g.albedo), g.schedule.getSlot(g.position));
+            Assert::AreNotEqual(g.schedule.getSlot(g.albedo), g.schedule.getSlot(g.outline));
+            Assert::AreNotEqual(g.schedule.getSlot(g.normal), g.schedule.getSlot(g.outline));
+            Assert::AreEqual(g.schedule.getSlots().size(), (size_t)5);
+        }
+
+        TEST_METHOD(DifferentFormatsOrSizesDontShare) {
+            RenderGraphSchedule s;
+            int x = s.addTarget(GL_RGBA16F);
+            int y = s.addTarget(GL_RGBA16F);
+            int half = s.addTarget(GL_RGBA16F, 0.5f);
+            int other = s.addTarget(GL_RGBA32F);
+            s.addPass({}, { x });
+            s.addPass({ x }, { y });
+            s.addPass({ y }, { half });
+            s.addPass({ half }, { other });
+            s.addPass({ other }, { RenderGraphSchedule::BACKBUFFER });
+            s.setBackbufferSize(16, 16);
+            s.compile();
+            Assert::AreNotEqual(s.getSlot(x), s.getSlot(half));
+            Assert::AreNotEqual(s.getSlot(x), s.getSlot(other));
+            int width, height;
+            s.getTargetSize(half, width, height);
+            Assert::AreEqual(width, 8);
+            Assert::AreEqual(height, 8);
+        }
+
+        TEST_METHOD(RenderScaleResizesTargets) {
+            BackendGraph g;
+            g.schedule.setRenderScale(0.5f);
+            g.schedule.compile();
+            int width, height;
+            g.schedule.getTargetSize(g.albedo, width, height);
+            Assert::AreEqual(width, 32);
+            Assert::AreEqual(height, 24);
+            g.schedule.getTargetSize(RenderGraphSchedule::BACKBUFFER, width, height);
+            Assert::AreEqual(width, 64);
+            Assert::AreEqual(height, 48);
+        }
+
+        TEST_METHOD(FirstWriterClears) {
+            BackendGraph g;
+            g.schedule.compile();
+            const std::vector<int>& gbufferClears = g.schedule.getClears(g.gbufferPass);
+            const std::vector<int>& outlineClears = g.schedule.getClears(g.outlinePass);
+            Assert::AreEqual(gbufferClears.size(), (size_t)4);
+            // Outlines draw over the scene's depth, so only the outline target is cleared
+            Assert::AreEqual(outlineClears.size(), (size_t)1);
+            Assert::AreEqual(outlineClears[0], g.outline);
+        }
+    };
+}
\ No newline at end of file
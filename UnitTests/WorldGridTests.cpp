@@ -0,0 +1,232 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "../MouseCraft/Core/Vector2D.cpp"
+#include "../MouseCraft/WorldGrid.cpp"
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace WorldGridTests {
+    // The grid only stores component pointers, it never dereferences them
+    static int placeholder;
+    static PhysicsComponent* const component = reinterpret_cast<PhysicsComponent*>(&placeholder);
+
+    TEST_CLASS(RectTests) {
+    public:
+        TEST_METHOD(CrossesWordBoundary) {
+            // 128 tiles wide, so each row is two words split between x = 63 and 64
+            WorldGrid grid(128, 16, 1);
+            grid.fillRect(OCCUPIED_LAYER, 60, 2, 70, 5);
+            Assert::IsFalse(grid.testTile(OCCUPIED_LAYER, 59, 3));
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 60, 3));
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 63, 3));
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 64, 3));
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 69, 3));
+            Assert::IsFalse(grid.testTile(OCCUPIED_LAYER, 70, 3));
+            Assert::IsFalse(grid.testTile(OCCUPIED_LAYER, 65, 1));
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 65, 2));
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 65, 4));
+            Assert::IsFalse(grid.testTile(OCCUPIED_LAYER, 65, 5));
+
+            Assert::IsTrue(grid.testRect(OCCUPIED_LAYER, 63, 4, 64, 5));
+            Assert::IsTrue(grid.testRect(OCCUPIED_LAYER, 64, 4, 65, 5));
+            Assert::IsFalse(grid.testRect(OCCUPIED_LAYER, 0, 2, 60, 5));
+            Assert::IsFalse(grid.testRect(OCCUPIED_LAYER, 70, 2, 128, 5));
+
+            // Clearing across the boundary leaves the tiles either side
+            grid.clearRect(OCCUPIED_LAYER, 62, 3, 66, 4);
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 61, 3));
+            Assert::IsFalse(grid.testRect(OCCUPIED_LAYER, 62, 3, 66, 4));
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 66, 3));
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 63, 2));
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 64, 4));
+        }
+
+        TEST_METHOD(WholeRow) {
+            WorldGrid grid(128, 16, 1);
+            grid.fillRect(OCCUPIED_LAYER, 0, 7, 128, 8);
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 0, 7));
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 127, 7));
+            Assert::IsFalse(grid.testRect(OCCUPIED_LAYER, 0, 0, 128, 7));
+            Assert::IsFalse(grid.testRect(OCCUPIED_LAYER, 0, 8, 128, 16));
+        }
+
+        TEST_METHOD(ClampedOnBothAxes) {
+            WorldGrid grid(128, 16, 1);
+            grid.fillRect(OCCUPIED_LAYER, -10, -5, 3, 2);
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 0, 0));
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 2, 1));
+            Assert::IsFalse(grid.testTile(OCCUPIED_LAYER, 3, 0));
+            Assert::IsFalse(grid.testTile(OCCUPIED_LAYER, 0, 2));
+
+            grid.fillRect(OCCUPIED_LAYER, 120, 14, 200, 40);
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 120, 14));
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 127, 15));
+            Assert::IsFalse(grid.testTile(OCCUPIED_LAYER, 119, 15));
+            Assert::IsFalse(grid.testTile(OCCUPIED_LAYER, 127, 13));
+
+            // Tests clamp the same way
+            Assert::IsTrue(grid.testRect(OCCUPIED_LAYER, 127, 15, 500, 500));
+            Assert::IsTrue(grid.testRect(OCCUPIED_LAYER, -500, -500, 1, 1));
+        }
+
+        TEST_METHOD(ReversedCorners) {
+            WorldGrid grid(128, 16, 1);
+            grid.fillRect(OCCUPIED_LAYER, 10, 5, 4, 2);
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 4, 2));
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 9, 4));
+            Assert::IsFalse(grid.testTile(OCCUPIED_LAYER, 10, 4));
+            Assert::IsFalse(grid.testTile(OCCUPIED_LAYER, 9, 5));
+        }
+
+        TEST_METHOD(FullyOutsideGrid) {
+            WorldGrid grid(128, 16, 1);
+            grid.fillRect(OCCUPIED_LAYER, 130, 0, 140, 5);
+            grid.fillRect(OCCUPIED_LAYER, -20, -20, -1, -1);
+            grid.fillRect(OCCUPIED_LAYER, 0, 16, 10, 20);
+            grid.fillRect(OCCUPIED_LAYER, -5, 20, 200, 30);
+            Assert::IsFalse(grid.testRect(OCCUPIED_LAYER, 0, 0, 128, 16));
+            Assert::IsFalse(grid.testRect(OCCUPIED_LAYER, 130, 0, 140, 5));
+            Assert::IsFalse(grid.testTile(OCCUPIED_LAYER, 128, 0));
+            Assert::IsFalse(grid.testTile(OCCUPIED_LAYER, -1, 0));
+        }
+
+        TEST_METHOD(EmptyRect) {
+            WorldGrid grid(128, 16, 1);
+            grid.fillRect(OCCUPIED_LAYER, 5, 5, 5, 10);
+            grid.fillRect(OCCUPIED_LAYER, 5, 5, 10, 5);
+            Assert::IsFalse(grid.testRect(OCCUPIED_LAYER, 0, 0, 128, 16));
+        }
+
+        TEST_METHOD(FillClearRoundTrip) {
+            WorldGrid grid(128, 16, 1);
+            grid.fillRect(OCCUPIED_LAYER, 30, 3, 100, 12);
+            Assert::IsTrue(grid.testRect(OCCUPIED_LAYER, 0, 0, 128, 16));
+            grid.clearRect(OCCUPIED_LAYER, 30, 3, 100, 12);
+            Assert::IsFalse(grid.testRect(OCCUPIED_LAYER, 0, 0, 128, 16));
+
+            // Clearing part of a rectangle leaves the rest
+            grid.fillRect(OCCUPIED_LAYER, 30, 3, 100, 12);
+            grid.clearRect(OCCUPIED_LAYER, 30, 3, 64, 12);
+            Assert::IsFalse(grid.testRect(OCCUPIED_LAYER, 0, 0, 64, 16));
+            Assert::IsTrue(grid.testRect(OCCUPIED_LAYER, 64, 3, 65, 4));
+            Assert::IsTrue(grid.testRect(OCCUPIED_LAYER, 99, 11, 100, 12));
+        }
+
+        TEST_METHOD(LayersAreSeparate) {
+            WorldGrid grid(128, 16, 1);
+            grid.fillRect(PLATFORM_LAYER, 0, 0, 128, 16);
+            Assert::IsFalse(grid.testRect(OCCUPIED_LAYER, 0, 0, 128, 16));
+            Assert::IsFalse(grid.testRect(UP_LAYER, 0, 0, 128, 16));
+            grid.clearRect(OCCUPIED_LAYER, 0, 0, 128, 16);
+            Assert::IsTrue(grid.testTile(PLATFORM_LAYER, 127, 15));
+        }
+    };
+
+    TEST_CLASS(PlacementTests) {
+    public:
+        TEST_METHOD(PositionAreaRejectsOccupied) {
+            // 10 x 10 tiles of 10 units
+            WorldGrid grid(100, 100, 10);
+            Vector2D a1(20, 50), a2(40, 30);
+            grid.createArea(a1, a2, component);
+            Assert::IsTrue(grid.objectAt(2, 3) == component);
+            Assert::IsTrue(grid.objectAt(3, 4) == component);
+
+            Vector2D b1(30, 40), b2(50, 20);
+            Assert::IsFalse(grid.positionArea(b1, b2));
+            // Left alone when rejected
+            Assert::AreEqual(b1.x, 30.0f);
+            Assert::AreEqual(b1.y, 40.0f);
+
+            // Snapped to the grid when the area is free
+            Vector2D c1(51, 38), c2(69, 22);
+            Assert::IsTrue(grid.positionArea(c1, c2));
+            Assert::AreEqual(c1.x, 50.0f);
+            Assert::AreEqual(c1.y, 40.0f);
+            Assert::AreEqual(c2.x, 70.0f);
+            Assert::AreEqual(c2.y, 20.0f);
+
+            Vector2D r1(20, 50), r2(40, 30);
+            Assert::IsTrue(grid.removeArea(r1, r2));
+            Vector2D d1(30, 40), d2(50, 20);
+            Assert::IsTrue(grid.positionArea(d1, d2));
+        }
+
+        TEST_METHOD(PositionObjectRejectsOccupied) {
+            WorldGrid grid(100, 100, 10);
+            Vector2D p(42, 58);
+            grid.createObject(p, component);
+            Vector2D q(38, 61);
+            Assert::IsFalse(grid.positionObject(q));
+            Vector2D r(52, 58);
+            Assert::IsTrue(grid.positionObject(r));
+            Assert::AreEqual(r.x, 50.0f);
+            Assert::AreEqual(r.y, 60.0f);
+        }
+
+        TEST_METHOD(RemoveComponentLeavesNeighbours) {
+            WorldGrid grid(100, 100, 10);
+            static int other;
+            PhysicsComponent* neighbour = reinterpret_cast<PhysicsComponent*>(&other);
+            Vector2D a1(20, 40), a2(40, 20);
+            grid.createArea(a1, a2, component);
+            Vector2D n(40, 30);
+            grid.createObject(n, neighbour);
+
+            grid.removeComponent(component, 20, 20, 40, 40);
+            Assert::IsTrue(grid.objectAt(2, 2) == nullptr);
+            Assert::IsFalse(grid.testTile(OCCUPIED_LAYER, 3, 3));
+            Assert::IsTrue(grid.objectAt(4, 3) == neighbour);
+            Assert::IsTrue(grid.testTile(OCCUPIED_LAYER, 4, 3));
+        }
+
+        TEST_METHOD(RemoveComponentFlippedCorners) {
+            WorldGrid grid(100, 100, 10);
+            Vector2D a1(20, 40), a2(40, 20);
+            grid.createArea(a1, a2, component);
+
+            grid.removeComponent(component, 20, 40, 40, 20);
+            Assert::IsFalse(grid.testRect(OCCUPIED_LAYER, 0, 0, 10, 10));
+            Assert::IsTrue(grid.objectAt(3, 3) == nullptr);
+        }
+    };
+
+    TEST_CLASS(PlatformTests) {
+    public:
+        TEST_METHOD(PlatformEdges) {
+            // The platform covers x and y from 20 to 40, tiles 2 and 3
+            WorldGrid grid(100, 100, 10);
+            grid.addPlatform(20, 20, 40, 40);
+            Assert::IsTrue(grid.platformInArea(25, 25, 25, 25));
+
+            // Touching the right edge isn't on it, just inside is
+            Assert::IsFalse(grid.platformInArea(40, 25, 50, 30));
+            Assert::IsTrue(grid.platformInArea(39.9f, 25, 50, 30));
+
+            // Touching the left edge isn't on it, just past it is
+            Assert::IsFalse(grid.platformInArea(10, 25, 20, 30));
+            Assert::IsTrue(grid.platformInArea(10, 25, 20.1f, 30));
+
+            // Same on the other axis, with the corners given in either order
+            Assert::IsFalse(grid.platformInArea(25, 50, 30, 40));
+            Assert::IsTrue(grid.platformInArea(30, 50, 25, 39.9f));
+        }
+
+        TEST_METHOD(RemovePlatform) {
+            WorldGrid grid(100, 100, 10);
+            grid.addPlatform(20, 20, 40, 40);
+            grid.addPlatform(60, 60, 80, 80);
+            grid.removePlatform(20, 20, 40, 40);
+            Assert::IsFalse(grid.platformInArea(20, 20, 40, 40));
+            Assert::IsTrue(grid.platformInArea(60, 60, 80, 80));
+        }
+
+        TEST_METHOD(PlatformOutsideGrid) {
+            WorldGrid grid(100, 100, 10);
+            grid.addPlatform(-50, -50, -10, -10);
+            Assert::IsFalse(grid.platformInArea(-50, -50, 100, 100));
+            Assert::IsFalse(grid.platformInArea(200, 200, 300, 300));
+        }
+    };
+}
\ No newline at end of file